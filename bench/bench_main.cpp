@@ -0,0 +1,490 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include <ftxui/dom/elements.hpp>
+#include <ftxui/dom/node.hpp>
+#include <ftxui/screen/screen.hpp>
+
+#include "alloc_counter.hpp"
+#include "autopilot.hpp"
+#include "board.hpp"
+#include "game.hpp"
+#include "harness.hpp"
+#include "letter.hpp"
+#include "persistence.hpp"
+#include "render_prep.hpp"
+#include "sfx.hpp"
+#include "shm_ring.hpp"
+#include "thread_queue.hpp"
+#include "timer_wheel.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using vday::bench::Runner;
+
+vday::GameSnapshot MakeSnapshot(int width, int height, int note_count, std::mt19937& rng) {
+  vday::GameSnapshot snapshot;
+  snapshot.width = width;
+  snapshot.height = height;
+  snapshot.player_x = width / 2;
+  std::uniform_int_distribution<int> x_dist(0, width - 2);
+  std::uniform_int_distribution<std::int32_t> y_dist(0, (std::min(height, 1000) - 1) * vday::kNoteRowUnits);
+  std::uniform_int_distribution<int> type_dist(0, static_cast<int>(vday::kItems.size()) - 1);
+  for (int i = 0; i < note_count; ++i) {
+    snapshot.notes.push_back(
+        vday::Note{x_dist(rng), y_dist(rng), static_cast<vday::ItemType>(type_dist(rng))});
+  }
+  vday::SortNotesByRow(snapshot.notes);
+  return snapshot;
+}
+
+// Producers push kPerProducer ints each while the calling thread consumes
+// with `pop`, which returns how many elements it took.
+template <typename Pop>
+void RunQueueContention(Runner& runner, const std::string& name, vday::ThreadSafeQueue<int>& queue,
+                        int producers, Pop pop) {
+  if (!runner.Selected(name)) {
+    return;
+  }
+  constexpr long kPerProducer = 200000;
+  std::atomic<bool> go{false};
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&] {
+      while (!go) {
+      }
+      for (long i = 0; i < kPerProducer; ++i) {
+        queue.Push(static_cast<int>(i));
+      }
+    });
+  }
+  const long total = kPerProducer * producers;
+  const auto start = Clock::now();
+  go = true;
+  long popped = 0;
+  while (popped < total) {
+    popped += static_cast<long>(pop());
+  }
+  const auto elapsed = Clock::now() - start;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  runner.Record(name, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed), total);
+}
+
+void BenchQueue(Runner& runner) {
+  for (int producers : {1, 2, 4, 8}) {
+    const std::string suffix = "/producers=" + std::to_string(producers);
+    int value = 0;
+    std::vector<int> batch;
+
+    vday::ThreadSafeQueue<int> unbounded;
+    RunQueueContention(runner, "queue/push_pop" + suffix, unbounded, producers,
+                       [&] { return unbounded.TryPop(value) ? 1 : 0; });
+
+    vday::ThreadSafeQueue<int> drained;
+    RunQueueContention(runner, "queue/push_drain" + suffix, drained, producers, [&] {
+      batch.clear();
+      return drained.DrainInto(batch);
+    });
+
+    // A small bound keeps producers parked on the not-full condition.
+    vday::ThreadSafeQueue<int> bounded(1024, vday::OverflowPolicy::Block);
+    RunQueueContention(runner, "queue/bounded_block" + suffix, bounded, producers, [&] {
+      batch.clear();
+      return bounded.DrainInto(batch);
+    });
+  }
+
+  // Pushes into a full drop-oldest queue: the cost of shedding load.
+  for (int producers : {1, 4}) {
+    const std::string name = "queue/drop_oldest_push/producers=" + std::to_string(producers);
+    if (!runner.Selected(name)) {
+      continue;
+    }
+    constexpr long kPerProducer = 200000;
+    vday::ThreadSafeQueue<int> queue(256, vday::OverflowPolicy::DropOldest);
+    std::vector<std::thread> threads;
+    const auto start = Clock::now();
+    for (int p = 0; p < producers; ++p) {
+      threads.emplace_back([&] {
+        for (long i = 0; i < kPerProducer; ++i) {
+          queue.Push(static_cast<int>(i));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    runner.Record(name, std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start),
+                  kPerProducer * producers);
+  }
+}
+
+void BenchSimulation(Runner& runner) {
+  std::mt19937 rng(42);
+  for (int note_count : {0, 10, 100, 1000, 10000}) {
+    // A very tall board keeps notes from reaching the catcher during the run;
+    // the state is restored periodically so spawns do not inflate the count.
+    // The tick itself only touches notes at the catcher row, so without
+    // checkpoints the cost should not grow with note_count. A checkpoint
+    // copies every note, so the checkpointed variant grows by about
+    // note_count / interval note copies per tick.
+    const vday::GameSnapshot base = MakeSnapshot(40, 1000000, note_count, rng);
+    for (bool checkpoints : {false, true}) {
+      vday::GameEngine engine;
+      engine.Seed(7);
+      engine.Restore(base);
+      if (!checkpoints) {
+        engine.SetCheckpointInterval(0);
+      }
+      int ticks = 0;
+      runner.Run(std::string(checkpoints ? "game/step_checkpointed" : "game/step") +
+                     "/notes=" + std::to_string(note_count),
+                 [&] {
+                   engine.RunTicks(1);
+                   if (++ticks % 4096 == 0) {
+                     engine.Restore(base);
+                   }
+                 });
+    }
+  }
+
+  for (int note_count : {10, 1000}) {
+    vday::GameEngine engine;
+    engine.Restore(MakeSnapshot(40, 20, note_count, rng));
+    runner.Run("game/snapshot/notes=" + std::to_string(note_count), [&] {
+      auto snapshot = engine.Snapshot();
+      (void)snapshot;
+    });
+
+    std::vector<std::uint8_t> state;
+    runner.Run("game/save_state/notes=" + std::to_string(note_count),
+               [&] { engine.SaveState(state); });
+    runner.Run("game/load_state/notes=" + std::to_string(note_count),
+               [&] { engine.LoadState(state); });
+  }
+}
+
+// Publish cost with 0..8 reader threads spinning on the newest frame. The
+// mapping is shared exactly as it would be with reader processes.
+void BenchShmRing(Runner& runner) {
+  const std::string name = "/vday_bench_" + std::to_string(getpid());
+  vday::ShmSnapshotWriter writer;
+  std::string error;
+  if (!writer.Open(name, 1024, error)) {
+    return;
+  }
+  std::mt19937 rng(5);
+  const vday::GameSnapshot snapshot = MakeSnapshot(40, 20, 100, rng);
+  writer.Publish(snapshot);
+
+  for (int readers : {0, 1, 2, 4, 8}) {
+    const std::string bench_name = "shm/publish/readers=" + std::to_string(readers);
+    if (!runner.Selected(bench_name)) {
+      continue;
+    }
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+      threads.emplace_back([&] {
+        vday::ShmSnapshotReader reader;
+        std::string reader_error;
+        if (!reader.Open(name, reader_error)) {
+          return;
+        }
+        vday::GameSnapshot out;
+        while (!stop.load(std::memory_order_relaxed)) {
+          reader.ReadLatest(out);
+        }
+      });
+    }
+    runner.Run(bench_name, [&] { writer.Publish(snapshot); });
+    stop = true;
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  vday::ShmSnapshotReader reader;
+  if (reader.Open(name, error)) {
+    vday::GameSnapshot out;
+    runner.Run("shm/read_latest", [&] { reader.ReadLatest(out); });
+  }
+}
+
+// Periods up to ~1 s in microseconds, like the app's timers. Each timer
+// re-arms itself when it fires, so the wheel keeps the same number pending.
+struct PeriodicTimers {
+  vday::TimerWheel wheel;
+  std::mt19937 rng{21};
+  std::uniform_int_distribution<std::uint64_t> period{1, 1 << 20};
+
+  void Arm() {
+    wheel.Schedule(wheel.now() + period(rng), [this] { Arm(); });
+  }
+};
+
+void BenchTimerWheel(Runner& runner) {
+  for (int pending : {16, 1024, 65536}) {
+    PeriodicTimers timers;
+    for (int i = 0; i < pending; ++i) {
+      timers.Arm();
+    }
+    vday::TimerWheel& wheel = timers.wheel;
+    const std::string suffix = "/pending=" + std::to_string(pending);
+    runner.Run("timers/schedule_cancel" + suffix, [&] {
+      wheel.Cancel(wheel.Schedule(wheel.now() + timers.period(timers.rng), [] {}));
+    });
+    // One 16 ms frame of clock per advance.
+    runner.Run("timers/advance_16ms" + suffix, [&] { wheel.Advance(wheel.now() + 16000); });
+  }
+}
+
+void BenchAutopilot(Runner& runner) {
+  std::mt19937 rng(99);
+  for (int note_count : {3, 30}) {
+    vday::GameSnapshot snapshot = MakeSnapshot(40, 20, note_count, rng);
+    vday::Autopilot autopilot;
+    runner.Run("autopilot/decide/notes=" + std::to_string(note_count), [&] {
+      vday::InputAction action;
+      autopilot.Decide(snapshot, action);
+    });
+  }
+}
+
+void BenchBoards(Runner& runner) {
+  std::mt19937 rng(1234);
+  for (auto [width, height] : {std::pair{40, 20}, std::pair{300, 80}}) {
+    const std::string size = std::to_string(width) + "x" + std::to_string(height);
+    const int note_count = std::max(1, width * height / 20);
+    // Two alternating frames so the cell backend sees real changes each time.
+    vday::GameSnapshot frames[2] = {MakeSnapshot(width, height, note_count, rng),
+                                    MakeSnapshot(width, height, note_count, rng)};
+    auto screen = ftxui::Screen::Create(ftxui::Dimension::Fixed(width + 2),
+                                        ftxui::Dimension::Fixed(height + 2));
+    int frame = 0;
+
+    runner.Run("board/canvas/" + size, [&] {
+      ftxui::Render(screen, vday::RenderGameCanvas(frames[frame++ & 1]));
+    });
+
+    vday::CellBoard board;
+    runner.Run("board/cells/" + size, [&] {
+      board.Update(frames[frame++ & 1]);
+      ftxui::Render(screen, board.Render());
+    });
+  }
+}
+
+// UI-thread cost of a game frame with the board and a revealing letter:
+// preparing the frame and drawing it.
+void BenchRenderPrep(Runner& runner) {
+  std::mt19937 rng(8);
+  const vday::GameSnapshot base = MakeSnapshot(40, 20, 100, rng);
+  const std::vector<std::string> letter(
+      6, "Every note that falls is a little piece of this letter, caught and kept for you.");
+  for (const auto backend : {vday::BoardBackend::Canvas, vday::BoardBackend::Cells}) {
+    const std::string name = std::string("render_prep/") +
+                             (backend == vday::BoardBackend::Cells ? "cells" : "canvas");
+    if (!runner.Selected(name)) {
+      continue;
+    }
+    vday::GameEngine engine;
+    engine.Restore(base);
+    vday::RenderPrep prep(engine);
+    prep.SetLetter(letter);
+    vday::PrepSettings settings;
+    settings.board = true;
+    settings.backend = backend;
+    settings.letter_width = 38;
+    settings.letter_shown.assign(letter.size(), letter[0].size());
+    auto screen = ftxui::Screen::Create(ftxui::Dimension::Fixed(82), ftxui::Dimension::Fixed(23));
+    size_t frame = 0;
+    runner.Run(name, [&] {
+      const vday::PreparedFrame& prepared = prep.Acquire(settings);
+      ftxui::Elements lines;
+      for (const auto& chunk : prepared.letter) {
+        for (const auto& line : *chunk) {
+          lines.push_back(ftxui::text(line));
+        }
+      }
+      ftxui::Render(screen, ftxui::hbox({backend == vday::BoardBackend::Cells ? prepared.cells.Render()
+                                                                             : prepared.canvas,
+                                         ftxui::vbox(std::move(lines))}));
+      // One chunk reveals a character a frame, so it is rewrapped every time.
+      settings.letter_shown[0] = ++frame % letter[0].size();
+    });
+  }
+}
+
+// Allocations of one steady-state game frame on the UI thread, counted with
+// the counting operator new. The frame is the one the game screen draws: the
+// frame from RenderPrep, and the game panel and letter panel side by side. The
+// tick, snapshot copy, board fill and stats line must not allocate at all.
+// FTXUI builds a fresh element tree every frame, so the whole frame gets a
+// fixed budget, and a frame full of notes must also not allocate more than
+// the empty board measured in the same run. The canvas backend allocates
+// inside ftxui::Canvas for every cell drawn, so it is reported but not held to
+// any limit. Returns false when over.
+bool CheckFrameAllocations() {
+  constexpr int kWarmupFrames = 2000;
+  constexpr int kMeasuredFrames = 2000;
+  // The element tree of both panels is under a hundred nodes and vectors;
+  // the rest is headroom for differences between FTXUI versions.
+  constexpr std::uint64_t kFrameBudget = 128;
+  if (!vday::AllocationCounting()) {
+    std::fprintf(stderr, "alloc/frame: counting operator new is not linked in\n");
+    return false;
+  }
+  struct FrameCost {
+    std::uint64_t core = 0;
+    std::uint64_t full = 0;
+  };
+  const std::vector<std::string> letter(
+      6, "Every note that falls is a little piece of this letter, caught and kept for you.");
+  std::mt19937 rng(21);
+  auto measure = [&](vday::BoardBackend backend, int note_count) {
+    // Restored every 16 frames, like the step bench, to hold the note count.
+    const vday::GameSnapshot base = MakeSnapshot(40, 20, note_count, rng);
+    vday::GameEngine engine;
+    engine.Seed(3);
+    engine.Restore(base);
+    vday::RenderPrep prep(engine);
+    prep.SetLetter(letter);
+    // Wrapped at a fixed width, as the app does once the panel is measured.
+    vday::PrepSettings settings;
+    settings.board = true;
+    settings.backend = backend;
+    settings.letter_width = 38;
+    settings.letter_shown.assign(letter.size(), letter[0].size());
+    std::vector<vday::LetterBlock> letter_blocks;
+    auto unprepared = [&](size_t i) { return ftxui::paragraph(letter[i]); };
+    int letter_width = 0;
+    std::string stats;
+    auto screen = ftxui::Screen::Create(ftxui::Dimension::Fixed(100), ftxui::Dimension::Fixed(29));
+
+    FrameCost cost;
+    for (int frame = 0; frame < kWarmupFrames + kMeasuredFrames; ++frame) {
+      if (frame % 16 == 0) {
+        engine.Restore(base);
+      }
+      const std::uint64_t before = vday::ThreadAllocations().count;
+      engine.RunTicks(1);
+      const vday::PreparedFrame& prepared = prep.Acquire(settings);
+      vday::FormatScoreLine(prepared.snapshot, stats);
+      vday::AppendStat(stats, "  Unlocked: ", prepared.snapshot.unlocked_chunks);
+      const std::uint64_t after_core = vday::ThreadAllocations().count;
+      auto game_panel = vday::RenderGamePanel(prepared, backend, ftxui::text(stats));
+      auto letter_panel = vday::RenderLetterPanel(prepared, letter.size(), letter_blocks,
+                                                  unprepared, false, &letter_width);
+      ftxui::Render(screen, ftxui::hbox({
+                                game_panel | ftxui::flex,
+                                letter_panel | ftxui::flex,
+                            }));
+      const std::uint64_t after_frame = vday::ThreadAllocations().count;
+      if (frame >= kWarmupFrames) {
+        cost.core = std::max(cost.core, after_core - before);
+        cost.full = std::max(cost.full, after_frame - before);
+      }
+    }
+    return cost;
+  };
+
+  bool ok = true;
+  for (const auto backend : {vday::BoardBackend::Cells, vday::BoardBackend::Canvas}) {
+    const bool cells = backend == vday::BoardBackend::Cells;
+    const FrameCost empty = measure(backend, 0);
+    for (int note_count : {0, 10, 1000}) {
+      const FrameCost cost = note_count == 0 ? empty : measure(backend, note_count);
+      std::printf("alloc/frame/%s/notes=%d: core %llu, full frame %llu (budget %llu, "
+                  "empty board %llu)\n",
+                  cells ? "cells" : "canvas", note_count,
+                  static_cast<unsigned long long>(cost.core),
+                  static_cast<unsigned long long>(cost.full),
+                  static_cast<unsigned long long>(kFrameBudget),
+                  static_cast<unsigned long long>(empty.full));
+      if (cells && (cost.core != 0 || cost.full > kFrameBudget || cost.full > empty.full)) {
+        std::fprintf(stderr, "alloc/frame/cells/notes=%d: over the allocation budget\n",
+                     note_count);
+        ok = false;
+      }
+    }
+  }
+  return ok;
+}
+
+void BenchLetter(Runner& runner) {
+  for (size_t paragraphs : {10u, 10000u}) {
+    std::string text;
+    for (size_t i = 0; i < paragraphs; ++i) {
+      text += "Dear you, this is line one of paragraph " + std::to_string(i) + ".\n";
+      text += "And here is a second, somewhat longer line to wrap across the panel.\n\n";
+    }
+    runner.Run("letter/split/paragraphs=" + std::to_string(paragraphs), [&] {
+      auto chunks = vday::SplitParagraphs(text);
+      (void)chunks;
+    });
+  }
+}
+
+void BenchSfx(Runner& runner) {
+  runner.Run("sfx/synthesize_all", [] {
+    for (auto effect : {vday::SoundEffect::Catch, vday::SoundEffect::Miss, vday::SoundEffect::Unlock}) {
+      auto pcm = vday::SynthesizeEffect(effect, 44100, 2);
+      (void)pcm;
+    }
+  });
+}
+
+void BenchPersistence(Runner& runner) {
+  const std::filesystem::path dir =
+      std::filesystem::temp_directory_path() / ("vday_bench_" + std::to_string(getpid()));
+  std::filesystem::create_directories(dir);
+  setenv("XDG_STATE_HOME", dir.c_str(), 1);
+
+  vday::Persistence persistence;
+  vday::ProgressData data;
+  data.unlocked_chunks = 3;
+  data.best_score = 1234;
+  runner.Run("persistence/save", [&] { persistence.Save(data); });
+  runner.Run("persistence/load", [&] {
+    auto loaded = persistence.Load();
+    (void)loaded;
+  });
+
+  std::error_code ec;
+  std::filesystem::remove_all(dir, ec);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Runner runner(argc, argv);
+  BenchQueue(runner);
+  BenchSimulation(runner);
+  BenchShmRing(runner);
+  BenchTimerWheel(runner);
+  BenchAutopilot(runner);
+  BenchBoards(runner);
+  BenchRenderPrep(runner);
+  BenchLetter(runner);
+  BenchSfx(runner);
+  BenchPersistence(runner);
+  const bool allocations_ok = !runner.Selected("alloc/frame") || CheckFrameAllocations();
+  const int status = runner.Finish();
+  return status != 0 ? status : (allocations_ok ? 0 : 1);
+}
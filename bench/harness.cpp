@@ -0,0 +1,155 @@
+#include "harness.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace vday::bench {
+
+namespace {
+
+std::string ToJson(const std::vector<Result>& results) {
+  std::ostringstream out;
+  out << "{\n  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto& result = results[i];
+    char ns[32];
+    std::snprintf(ns, sizeof(ns), "%.1f", result.ns_per_op);
+    out << "    {\"name\": \"" << result.name << "\", \"ns_per_op\": " << ns
+        << ", \"iterations\": " << result.iterations << "}";
+    out << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  out << "  ]\n}\n";
+  return out.str();
+}
+
+// Reads the files this harness writes; not a general JSON parser.
+std::vector<Result> ParseJson(const std::string& content) {
+  std::vector<Result> results;
+  size_t pos = 0;
+  const std::string name_key = "\"name\": \"";
+  const std::string ns_key = "\"ns_per_op\": ";
+  while ((pos = content.find(name_key, pos)) != std::string::npos) {
+    pos += name_key.size();
+    const size_t name_end = content.find('"', pos);
+    if (name_end == std::string::npos) {
+      break;
+    }
+    Result result;
+    result.name = content.substr(pos, name_end - pos);
+    const size_t ns_pos = content.find(ns_key, name_end);
+    if (ns_pos == std::string::npos) {
+      break;
+    }
+    try {
+      result.ns_per_op = std::stod(content.substr(ns_pos + ns_key.size()));
+    } catch (...) {
+      continue;
+    }
+    results.push_back(result);
+    pos = ns_pos;
+  }
+  return results;
+}
+
+bool WriteFile(const std::string& path, const std::string& content) {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file.is_open()) {
+    std::cerr << "Cannot write " << path << "\n";
+    return false;
+  }
+  file << content;
+  return true;
+}
+
+}  // namespace
+
+Runner::Runner(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    auto value_of = [&](const std::string& prefix, std::string& out) {
+      if (arg.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+      }
+      out = arg.substr(prefix.size());
+      return true;
+    };
+    std::string tolerance;
+    if (value_of("--filter=", filter_) || value_of("--json=", json_path_) ||
+        value_of("--baseline=", baseline_path_)) {
+      continue;
+    }
+    if (arg == "--update-baseline") {
+      update_baseline_ = true;
+    } else if (value_of("--tolerance=", tolerance)) {
+      try {
+        tolerance_ = std::stod(tolerance);
+      } catch (...) {
+        std::cerr << "Invalid tolerance: " << tolerance << "\n";
+      }
+    } else {
+      std::cerr << "Unknown option: " << arg << "\n";
+    }
+  }
+}
+
+void Runner::Record(const std::string& name, std::chrono::nanoseconds elapsed, long operations) {
+  Result result;
+  result.name = name;
+  result.iterations = operations;
+  result.ns_per_op = operations > 0
+                         ? static_cast<double>(elapsed.count()) / static_cast<double>(operations)
+                         : 0.0;
+  std::printf("%-44s %12.1f ns/op %12ld ops\n", name.c_str(), result.ns_per_op, operations);
+  std::fflush(stdout);
+  results_.push_back(result);
+}
+
+bool Runner::Selected(const std::string& name) const {
+  return filter_.empty() || name.find(filter_) != std::string::npos;
+}
+
+int Runner::Finish() {
+  const std::string json = ToJson(results_);
+  if (!json_path_.empty()) {
+    WriteFile(json_path_, json);
+  }
+  if (update_baseline_) {
+    return WriteFile(baseline_path_, json) ? 0 : 1;
+  }
+
+  std::ifstream file(baseline_path_);
+  if (!file.is_open()) {
+    // Nothing to compare against is a failed gate, not a pass.
+    std::cout << "No baseline at " << baseline_path_ << "; run with --update-baseline to create one.\n";
+    return 1;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  const std::vector<Result> baseline = ParseJson(buffer.str());
+
+  int regressions = 0;
+  for (const auto& result : results_) {
+    for (const auto& base : baseline) {
+      if (base.name != result.name || base.ns_per_op <= 0.0) {
+        continue;
+      }
+      const double ratio = result.ns_per_op / base.ns_per_op;
+      if (ratio > 1.0 + tolerance_) {
+        std::printf("REGRESSION %-33s %12.1f -> %12.1f ns/op (%+.0f%%)\n", result.name.c_str(),
+                    base.ns_per_op, result.ns_per_op, (ratio - 1.0) * 100.0);
+        regressions++;
+      }
+    }
+  }
+  if (regressions > 0) {
+    std::printf("%d benchmark(s) regressed beyond %.0f%% of %s\n", regressions, tolerance_ * 100.0,
+                baseline_path_.c_str());
+    return 1;
+  }
+  std::printf("No regressions against %s\n", baseline_path_.c_str());
+  return 0;
+}
+
+}  // namespace vday::bench
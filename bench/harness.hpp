@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#ifndef VDAY_BENCH_BASELINE
+#define VDAY_BENCH_BASELINE "bench/baseline.json"
+#endif
+
+namespace vday::bench {
+
+struct Result {
+  std::string name;
+  double ns_per_op = 0.0;
+  long iterations = 0;
+};
+
+class Runner {
+ public:
+  // Parses --filter=, --json=, --baseline=, --update-baseline and --tolerance=.
+  Runner(int argc, char** argv);
+
+  // Runs fn repeatedly for at least min_time and records the mean cost per call.
+  template <typename Fn>
+  void Run(const std::string& name, Fn&& fn,
+           std::chrono::milliseconds min_time = std::chrono::milliseconds(300)) {
+    if (!Selected(name)) {
+      return;
+    }
+    using Clock = std::chrono::steady_clock;
+    for (int warmup = 0; warmup < 3; ++warmup) {
+      fn();
+    }
+    long iterations = 0;
+    const auto start = Clock::now();
+    auto elapsed = Clock::duration::zero();
+    while (elapsed < min_time) {
+      fn();
+      iterations++;
+      elapsed = Clock::now() - start;
+    }
+    Record(name, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed), iterations);
+  }
+
+  // Records a measurement taken by the caller (for multi-threaded cases).
+  void Record(const std::string& name, std::chrono::nanoseconds elapsed, long operations);
+  bool Selected(const std::string& name) const;
+
+  // Writes JSON and compares against the baseline. Returns the process exit code.
+  int Finish();
+
+ private:
+  std::string filter_;
+  std::string json_path_;
+  // The committed baseline in the source tree, whatever the working directory.
+  std::string baseline_path_ = VDAY_BENCH_BASELINE;
+  bool update_baseline_ = false;
+  double tolerance_ = 0.25;
+  std::vector<Result> results_;
+};
+
+}  // namespace vday::bench
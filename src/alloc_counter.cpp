@@ -0,0 +1,45 @@
+#include "alloc_counter.hpp"
+
+#include <atomic>
+
+namespace vday {
+
+namespace {
+
+// Constant-initialized, so allocations made before main() count too.
+std::atomic<bool> g_installed{false};
+std::atomic<std::uint64_t> g_count{0};
+std::atomic<std::uint64_t> g_bytes{0};
+thread_local AllocationStats t_stats;
+
+}  // namespace
+
+bool AllocationCounting() {
+  return g_installed.load(std::memory_order_relaxed);
+}
+
+AllocationStats ProcessAllocations() {
+  return AllocationStats{g_count.load(std::memory_order_relaxed),
+                         g_bytes.load(std::memory_order_relaxed)};
+}
+
+AllocationStats ThreadAllocations() {
+  return t_stats;
+}
+
+namespace detail {
+
+void CountAllocation(std::size_t bytes) {
+  g_count.fetch_add(1, std::memory_order_relaxed);
+  g_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  t_stats.count++;
+  t_stats.bytes += bytes;
+}
+
+void MarkAllocationHooksInstalled() {
+  g_installed.store(true, std::memory_order_relaxed);
+}
+
+}  // namespace detail
+
+}  // namespace vday
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vday {
+
+// Heap allocation counters, fed by the replacement operator new in
+// alloc_hooks.cpp. Only executables built with that file count: vday_bench
+// always, the others in Debug builds. Elsewhere AllocationCounting() is false
+// and the counters stay at zero.
+struct AllocationStats {
+  std::uint64_t count = 0;
+  std::uint64_t bytes = 0;
+};
+
+bool AllocationCounting();
+// All threads since startup.
+AllocationStats ProcessAllocations();
+// The calling thread only, so background threads do not blur a measurement.
+AllocationStats ThreadAllocations();
+
+namespace detail {
+void CountAllocation(std::size_t bytes);
+void MarkAllocationHooksInstalled();
+}  // namespace detail
+
+}  // namespace vday
@@ -1,130 +1,29 @@
 #include "app.hpp"
 
 #include <algorithm>
-#include <filesystem>
-#include <fstream>
-#include <sstream>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <variant>
 
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/event.hpp>
 #include <ftxui/component/screen_interactive.hpp>
-#include <ftxui/dom/canvas.hpp>
 #include <ftxui/dom/elements.hpp>
 
-namespace vday {
-
-namespace {
-
-std::vector<std::string> SplitParagraphs(const std::string& text) {
-  std::vector<std::string> chunks;
-  std::string current;
-  std::istringstream input(text);
-  std::string line;
-  bool last_blank = false;
-
-  while (std::getline(input, line)) {
-    if (line.empty()) {
-      if (!current.empty()) {
-        chunks.push_back(current);
-        current.clear();
-      }
-      last_blank = true;
-      continue;
-    }
-    if (last_blank && !current.empty()) {
-      chunks.push_back(current);
-      current.clear();
-    }
-    if (!current.empty()) {
-      current += "\n";
-    }
-    current += line;
-    last_blank = false;
-  }
-  if (!current.empty()) {
-    chunks.push_back(current);
-  }
-  return chunks;
-}
-
-std::string Repeat(const std::string& value, int count) {
-  std::string out;
-  if (count <= 0) {
-    return out;
-  }
-  out.reserve(static_cast<size_t>(count) * value.size());
-  for (int i = 0; i < count; ++i) {
-    out += value;
-  }
-  return out;
-}
-
-ftxui::Element RenderGameCanvas(const GameSnapshot& snapshot) {
-  using namespace ftxui;
-  constexpr int kCanvasCellWidth = 2;
-  constexpr int kCanvasCellHeight = 4;
-  auto cx = [&](int cell_x) { return cell_x * kCanvasCellWidth; };
-  auto cy = [&](int cell_y) { return cell_y * kCanvasCellHeight; };
-
-  Canvas canvas((snapshot.width + 2) * kCanvasCellWidth,
-                (snapshot.height + 2) * kCanvasCellHeight);
-
-  const std::string top = "\xE2\x94\x8C" + Repeat("\xE2\x94\x80", snapshot.width) + "\xE2\x94\x90";  // ┌ ─ ┐
-  const std::string bottom = "\xE2\x94\x94" + Repeat("\xE2\x94\x80", snapshot.width) + "\xE2\x94\x98";  // └ ─ ┘
-  canvas.DrawText(cx(0), cy(0), top);
-  for (int y = 1; y <= snapshot.height; ++y) {
-    canvas.DrawText(cx(0), cy(y), "\xE2\x94\x82");  // │
-    canvas.DrawText(cx(snapshot.width + 1), cy(y), "\xE2\x94\x82");  // │
-  }
-  canvas.DrawText(cx(0), cy(snapshot.height + 1), bottom);
-
-  for (const auto& note : snapshot.notes) {
-    int y = static_cast<int>(note.y);
-    if (y < 0 || y >= snapshot.height) {
-      continue;
-    }
-    std::string symbol = "?";
-    Color color = Color::White;
-    switch (note.type) {
-      case ItemType::Heart:
-        symbol = "\xF0\x9F\x92\x96";  // 💖
-        color = Color::RedLight;
-        break;
-      case ItemType::LoveNote:
-        symbol = "\xF0\x9F\x92\x8C";  // 💌
-        color = Color::YellowLight;
-        break;
-      case ItemType::Kiss:
-        symbol = "\xF0\x9F\x92\x8B";  // 💋
-        color = Color::MagentaLight;
-        break;
-      case ItemType::BrokenHeart:
-        symbol = "\xF0\x9F\x92\x94";  // 💔
-        color = Color::GrayLight;
-        break;
-    }
-    const int max_note_x = std::max(0, snapshot.width - ItemVisualWidth(note.type));
-    const int clamped_note_x = std::clamp(note.x, 0, max_note_x);
-    const int draw_x = 1 + clamped_note_x;
-    canvas.DrawText(cx(draw_x), cy(1 + y), symbol, color);
-  }
+#include "alloc_counter.hpp"
+#include "letter.hpp"
 
-  int catcher_y = 1 + CatcherRow(snapshot.height);
-  int start_x = 1 + CatcherStartColumn(snapshot.player_x, snapshot.width);
-  const bool catcher_flash = snapshot.catcher_flash_frames > 0;
-  const Color catcher_color = catcher_flash ? Color::YellowLight : Color::CyanLight;
-  // Draw catcher as a single token to avoid terminal-specific per-cell artifacts.
-  canvas.DrawText(cx(start_x), cy(catcher_y), "|___|", catcher_color);
-  if (catcher_flash && catcher_y > 1) {
-    const std::string sparkle = (snapshot.catcher_flash_frames % 2 == 0) ? " * " : " + ";
-    canvas.DrawText(cx(start_x + 1), cy(catcher_y - 1), sparkle, Color::White);
-  }
-  return ftxui::canvas(std::move(canvas));
-}
-
-}  // namespace
+namespace vday {
 
-App::App() {
+App::App(const AppOptions& options)
+    : options_(options),
+      frame_pacer_(options.remote_budget),
+      governor_(std::chrono::milliseconds(std::max(0, options.frame_budget_ms))) {
+  ui_events_ = game_.Events().Subscribe();
+  progress_events_ = game_.Events().Subscribe();
   menu_items_ = {"Rose Petal Salad", "Crimson Risotto", "Heartfire Steak", "Velvet Tiramisu"};
   menu_descriptions_ = {
       "Arugula, strawberries, feta, toasted almonds, balsamic glaze.",
@@ -133,24 +32,97 @@ App::App() {
       "Coffee-soaked layers, cacao, and berry syrup.",
   };
 
-  progress_ = persistence_.Load();
-  audio_requested_ = progress_.settings.audio_enabled;
-  last_unlocked_ = progress_.unlocked_chunks;
-
-  LoadLetter();
+  startup_.Mark("app constructed");
+  StartLoading();
   RefreshDashboardItems();
 }
 
+void App::StartLoading() {
+  // The save, the letter and the audio device come up in parallel; the UI
+  // starts right away and picks each result up in PollLoading().
+  audio_.SetStartupTrace(&startup_);
+  audio_.Attach(game_.Events());
+  audio_.SetThreadTuning(ThreadTuning{options_.audio_cpu, options_.rt_priority, options_.nice});
+  audio_.Start();
+  progress_future_ = std::async(std::launch::async, [this] {
+    LoadedSave save;
+    save.progress = persistence_.Load();
+    persistence_.LoadRun(save.run);
+    startup_.Mark("save loaded");
+    return save;
+  });
+  letter_future_ = std::async(std::launch::async, [this] {
+    std::string content;
+    if (!ReadLetterFile(LetterPath(), content)) {
+      content = "Dear You,\n\nThis is a placeholder letter.\n\nWith love,\nMe";
+    }
+    auto paragraphs = SplitParagraphs(content);
+    startup_.Mark("letter loaded");
+    return paragraphs;
+  });
+}
+
+void App::PollLoading(bool wait) {
+  auto ready = [wait](auto& future) {
+    return future.valid() &&
+           (wait || future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+  };
+  if (!progress_ready_ && ready(progress_future_)) {
+    LoadedSave save = progress_future_.get();
+    progress_ = std::move(save.progress);
+    saved_run_ = std::move(save.run);
+    audio_requested_ = progress_.settings.audio_enabled;
+    last_unlocked_ = progress_.unlocked_chunks;
+    PushAudioEnabled(audio_requested_);
+    progress_ready_ = true;
+    if (!saved_run_.empty()) {
+      RefreshDashboardItems();
+    }
+  }
+  // Letter state is derived from progress, so it waits for the save.
+  if (progress_ready_ && !letter_ready_ && ready(letter_future_)) {
+    LoadLetter(letter_future_.get());
+    letter_ready_ = true;
+    startup_.Mark("fully loaded");
+  }
+}
+
 void App::Run() {
+  game_.SetInputTracing(options_.latency_report);
+  game_.SetTickRate(options_.tick_rate);
+  game_.SetThreadTuning(ThreadTuning{options_.game_cpu, options_.rt_priority, options_.nice});
+  game_.SetCheckpointInterval(options_.checkpoint_ticks);
+  if (!options_.shm_ring.empty()) {
+    std::string error;
+    if (snapshot_ring_.Open(options_.shm_ring,
+                            static_cast<std::uint32_t>(std::max(0, options_.shm_notes)), error)) {
+      game_.SetSnapshotRing(&snapshot_ring_);
+    } else {
+      std::cerr << error << "\n";
+    }
+  }
+  // Run() opens on the dashboard, so the engine starts parked.
+  game_.Suspend();
   game_.Start();
-  audio_.Start();
-  PushAudioEnabled(audio_requested_);
+  assets_.Start(LetterPath().parent_path());
+  if (!options_.spectator_server.empty()) {
+    std::string error;
+    if (!spectators_.Start(options_.spectator_server, game_, options_.spectator_fps, error)) {
+      std::cerr << error << "\n";
+    }
+  }
 
   using namespace ftxui;
   auto screen = ScreenInteractive::Fullscreen();
   int tab_index = 0;
   auto set_screen = [&](Screen next) {
     screen_ = next;
+    // The simulation only runs while it is on screen.
+    if (screen_ == Screen::Game) {
+      game_.Resume();
+    } else {
+      game_.Suspend();
+    }
     switch (screen_) {
       case Screen::Dashboard:
         tab_index = 0;
@@ -186,8 +158,11 @@ void App::Run() {
         separator(),
         dashboard_menu->Render() | center,
         separator(),
-        text("Progress: " + std::to_string(progress_.unlocked_chunks) + " chunks") | center,
-        text("Best Score: " + std::to_string(progress_.best_score)) | center,
+        progress_ready_
+            ? text("Progress: " + std::to_string(progress_.unlocked_chunks) + " chunks") | center
+            : text("Loading progress...") | center | dim,
+        progress_ready_ ? text("Best Score: " + std::to_string(progress_.best_score)) | center
+                        : text(""),
         reset_confirm_pending_ ? text("Press Enter on Reset again to confirm") | center | bold
                                : text(""),
     });
@@ -203,10 +178,27 @@ void App::Run() {
       }
 
       const DashboardAction action = dashboard_actions_[dashboard_selected_];
+      const bool loaded = progress_ready_ && letter_ready_;
+      if (!loaded && action != DashboardAction::Quit) {
+        return true;
+      }
       if (action == DashboardAction::StartGame) {
         reset_confirm_pending_ = false;
+        // A fresh game replaces whatever run was saved.
+        if (!saved_run_.empty()) {
+          saved_run_.clear();
+          persistence_.ClearRun();
+        }
         set_screen(Screen::Game);
         game_.PushInput(InputAction::Reset);
+      } else if (action == DashboardAction::ResumeGame) {
+        reset_confirm_pending_ = false;
+        if (!saved_run_.empty()) {
+          game_.LoadState(saved_run_);
+          saved_run_.clear();
+          persistence_.ClearRun();
+        }
+        set_screen(Screen::Game);
       } else if (action == DashboardAction::Letter) {
         reset_confirm_pending_ = false;
         set_screen(Screen::Letter);
@@ -234,56 +226,76 @@ void App::Run() {
     return false;
   });
 
-  auto render_letter_progress = [&](bool show_escape_hint) {
-    UpdateLetterReveal();
-    Elements blocks;
-    for (size_t i = 0; i < letter_chunks_.size(); ++i) {
-      const auto& chunk = letter_chunks_[i];
-      if (static_cast<int>(i) < progress_.unlocked_chunks) {
-        std::string visible = chunk.text.substr(0, std::min(chunk.revealed, chunk.text.size()));
-        blocks.push_back(paragraph(visible));
-      } else {
-        blocks.push_back(paragraph("[Locked - play the game to reveal more]") | dim);
-      }
+  auto render_letter_progress = [&](bool show_escape_hint, const PreparedFrame& prepared) {
+    if (!governor_.AtLeast(QualityLevel::FrozenReveal)) {
+      ArmLetterReveal();
     }
-
-    Elements content = {
-        text("Letter Reveal") | bold | center,
-        separator(),
-        vbox(std::move(blocks)) | frame | flex,
+    // Until the first frame measures the panel, FTXUI wraps the paragraphs.
+    auto unprepared = [this](size_t i) {
+      auto& chunk = letter_chunks_[i];
+      const bool unlocked = static_cast<int>(i) < progress_.unlocked_chunks;
+      const size_t shown = unlocked ? std::min(chunk.revealed, chunk.text.size()) : 0;
+      if (!chunk.block || chunk.block_unlocked != unlocked || chunk.block_shown != shown) {
+        chunk.block = unlocked ? paragraph(chunk.text.substr(0, shown))
+                               : paragraph("[Locked - play the game to reveal more]") | dim;
+        chunk.block_unlocked = unlocked;
+        chunk.block_shown = shown;
+      }
+      return chunk.block;
     };
-    if (show_escape_hint) {
-      content.push_back(separator());
-      content.push_back(text("Esc to return") | center);
-    }
-    return vbox(std::move(content)) | border;
+    return RenderLetterPanel(prepared, letter_chunks_.size(), letter_blocks_, unprepared,
+                             show_escape_hint, &letter_width_);
   };
 
   auto game_view = Renderer([&] {
-    DrainGameEvents();
-    DrainAudioCommands();
-    auto snapshot = game_.Snapshot();
-    progress_.best_score = std::max(progress_.best_score, snapshot.score);
-
-    auto stats = hbox({
-        text("Score: " + std::to_string(snapshot.score)),
-        text("  Streak: " + std::to_string(snapshot.streak)),
-        text("  Misses: " + std::to_string(snapshot.misses)),
-        text("  Unlocked: " + std::to_string(progress_.unlocked_chunks)),
-        snapshot.paused ? text("  [PAUSED]") | bold : text(""),
-    });
+    DrainUiEvents();
+    if (AllocationCounting()) {
+      // Everything the UI thread allocated since the previous game frame.
+      const std::uint64_t allocations = ThreadAllocations().count;
+      frame_allocations_ = allocations - frame_start_allocations_;
+      frame_start_allocations_ = allocations;
+    }
+    const bool letter_panel_shown =
+        options_.show_letter_panel && !governor_.AtLeast(QualityLevel::NoLetterPanel);
+    const PreparedFrame& prepared = AcquireFrame(true, letter_panel_shown);
+    const GameSnapshot& snapshot = prepared.snapshot;
+    CollectInputTraces(snapshot);
+    if (options_.autopilot) {
+      autopilot_.Drive(game_, snapshot);
+    }
+    const bool show_unlock = show_unlock_banner_;
+
+    // One text node for the plain stats; the styled ones only when shown.
+    FormatScoreLine(snapshot, stats_line_);
+    AppendStat(stats_line_, "  Unlocked: ", progress_.unlocked_chunks);
+    if (options_.remote) {
+      AppendStat(stats_line_, "  B/frame: ", static_cast<long>(frame_pacer_.bytes_per_frame()));
+    }
+    if (options_.frame_budget_ms > 0) {
+      stats_line_ += "  Quality: ";
+      stats_line_ += QualityName(governor_.level());
+    }
+    if (AllocationCounting()) {
+      AppendStat(stats_line_, "  Allocs/frame: ", static_cast<long>(frame_allocations_));
+    }
+    Element stats = text(stats_line_);
+    if (snapshot.paused || show_unlock) {
+      Elements parts{stats};
+      if (snapshot.paused) {
+        parts.push_back(text("  [PAUSED]") | bold);
+      }
+      if (show_unlock) {
+        parts.push_back(text("  Chunk " + std::to_string(unlock_banner_chunk_) + " unlocked!") |
+                        bold | color(Color::MagentaLight));
+      }
+      stats = hbox(std::move(parts));
+    }
 
-    auto instructions = text("Arrows/A-D move  P pause  R reset  Esc back");
-    auto game_panel = vbox({
-                          text("Falling Love Notes") | bold | center,
-                          separator(),
-                          RenderGameCanvas(snapshot) | center,
-                          separator(),
-                          stats | center,
-                          instructions | center,
-                      }) |
-                      border;
-    auto letter_panel = render_letter_progress(false);
+    auto game_panel = RenderGamePanel(prepared, options_.board, std::move(stats));
+    if (!letter_panel_shown) {
+      return game_panel | flex;
+    }
+    auto letter_panel = render_letter_progress(false, prepared);
     return hbox({
         game_panel | flex,
         letter_panel | flex,
@@ -307,6 +319,10 @@ void App::Run() {
       game_.PushInput(InputAction::Reset);
       return true;
     }
+    if (event == Event::Character('b') || event == Event::Character('B')) {
+      game_.PushInput(InputAction::Rewind);
+      return true;
+    }
     if (event == Event::Escape) {
       set_screen(Screen::Dashboard);
       return true;
@@ -314,7 +330,7 @@ void App::Run() {
     return false;
   });
 
-  auto letter_view = Renderer([&] { return render_letter_progress(true); });
+  auto letter_view = Renderer([&] { return render_letter_progress(true, AcquireFrame(false, true)); });
 
   letter_view = CatchEvent(letter_view, [&](Event event) {
     if (event == Event::Escape) {
@@ -412,6 +428,10 @@ void App::Run() {
           game_.PushInput(InputAction::Reset);
           return true;
         }
+        if (c == "b" || c == "B") {
+          game_.PushInput(InputAction::Rewind);
+          return true;
+        }
       }
       if (event == Event::Escape) {
         set_screen(Screen::Dashboard);
@@ -429,16 +449,130 @@ void App::Run() {
     return false;
   });
 
+  // Paced frames (remote mode, or the governor's low-FPS level) come from
+  // frame_timer_; otherwise frames are driven by RequestAnimationFrame.
+  constexpr std::int64_t kLowFpsIntervalUs = 1000000 / QualityGovernor::kLowFps;
+
+  bool first_frame = true;
   auto root_renderer = Renderer(root, [&] {
-    screen.RequestAnimationFrame();
-    return root->Render();
+    const auto frame_start = std::chrono::steady_clock::now();
+    RunDueTimers();
+    PollLoading(false);
+    DrainProgressEvents();
+    DrainAssetUpdates();
+    if (first_frame) {
+      first_frame = false;
+      startup_.Mark("first frame rendered");
+      screen.Post([this] { startup_.Mark("first frame flushed"); });
+    }
+    std::int64_t interval_us = governor_.AtLeast(QualityLevel::LowFps) ? kLowFpsIntervalUs : 0;
+    if (options_.remote) {
+      // Bytes written since the previous render are that frame's output.
+      const std::uint64_t bytes = output_meter_.bytes();
+      frame_pacer_.OnFrame(bytes - last_output_bytes_);
+      last_output_bytes_ = bytes;
+      interval_us = std::max<std::int64_t>(interval_us, frame_pacer_.interval().count());
+    }
+    if (interval_us != 0) {
+      if (!timers_.Pending(frame_timer_)) {
+        // Firing is the whole job: the wakeup itself draws the next frame.
+        frame_timer_ = timers_.Schedule(TimerNow() + static_cast<std::uint64_t>(interval_us), [] {});
+      }
+    } else {
+      timers_.Cancel(frame_timer_);
+      screen.RequestAnimationFrame();
+    }
+    auto document = root->Render();
+    PublishNextTimer();
+    // Runs after FTXUI has drawn and flushed this frame, so the governor sees
+    // the whole cost.
+    screen.Post([this, frame_start] {
+      governor_.OnFrame(std::chrono::steady_clock::now() - frame_start);
+    });
+    if (!frame_traces_.empty()) {
+      // Posted tasks run on the next loop iteration, after this frame is flushed.
+      screen.Post([this] { MarkInputTracesFlushed(); });
+    }
+    return document;
+  });
+
+  if (options_.remote) {
+    output_meter_.Install();
+  }
+  // Sleeps until the earliest UI timer is due, then wakes the UI thread once
+  // for everything due by then. A new earliest deadline wakes it early; with
+  // no timers armed it sleeps on the condition variable.
+  bool timing = true;  // guarded by timer_mutex_
+  std::thread timer_thread([&] {
+    std::unique_lock<std::mutex> lock(timer_mutex_);
+    while (timing) {
+      const std::int64_t due = next_timer_us_;
+      const auto changed = [&] { return !timing || next_timer_us_ != due; };
+      if (due < 0) {
+        timer_cv_.wait(lock, changed);
+        continue;
+      }
+      const auto deadline = timer_epoch_ + std::chrono::microseconds(due);
+      if (timer_cv_.wait_until(lock, deadline, changed)) {
+        continue;
+      }
+      timer_wake_jitter_.Add(std::chrono::steady_clock::now() - deadline);
+      screen.PostEvent(Event::Custom);
+      // The UI thread fires the timer and publishes the next deadline.
+      timer_cv_.wait(lock, changed);
+    }
   });
 
   screen.Loop(root_renderer);
 
+  {
+    std::lock_guard<std::mutex> lock(timer_mutex_);
+    timing = false;
+  }
+  timer_cv_.notify_one();
+  timer_thread.join();
+  output_meter_.Uninstall();
+
+  spectators_.Stop();
+  assets_.Stop();
   game_.Stop();
   audio_.Stop();
+  // Never overwrite the save with defaults because we quit before it loaded.
+  PollLoading(true);
   persistence_.Save(progress_);
+  // A run left mid-game is kept for Resume on the next launch; a saved run
+  // that was never resumed stays as it is.
+  if (RunInProgress(game_.Snapshot())) {
+    std::vector<std::uint8_t> run;
+    game_.SaveState(run);
+    persistence_.SaveRun(run);
+  }
+
+  if (options_.latency_report) {
+    std::cerr << latency_.Report();
+  }
+  if (options_.startup_trace) {
+    std::cerr << startup_.Report();
+  }
+  if (options_.thread_report) {
+    std::cerr << "threads\n  " << game_.ThreadSummary() << "\n  " << audio_.ThreadSummary() << "\n";
+    std::cerr << JitterStats::Header() << game_.TickJitter().Report("game tick")
+              << audio_.WakeJitter().Report("audio wake")
+              << timer_wake_jitter_.Report("ui timer wake");
+    std::cerr << "ui timers: " << timer_wake_jitter_.Count() << " wakeups, " << timers_fired_
+              << " fired\n";
+    std::cerr << "queue drops: input " << game_.DroppedInputs() << ", audio "
+              << audio_.DroppedCommands() << ", assets " << assets_.DroppedUpdates()
+              << ", bus ui " << game_.Events().Dropped(ui_events_) << ", bus progress "
+              << game_.Events().Dropped(progress_events_) << "\n";
+    if (!options_.spectator_server.empty()) {
+      std::cerr << spectators_.Summary() << "\n";
+    }
+  }
+}
+
+bool App::RunInProgress(const GameSnapshot& snapshot) {
+  return snapshot.score != 0 || snapshot.misses != 0 || !snapshot.notes.empty();
 }
 
 bool App::IsGameCompleted() const {
@@ -452,6 +586,15 @@ void App::RefreshDashboardItems() {
   dashboard_items_.clear();
   dashboard_actions_.clear();
 
+  bool resumable = !saved_run_.empty();
+  if (!resumable) {
+    game_.SnapshotInto(frame_snapshot_);
+    resumable = RunInProgress(frame_snapshot_);
+  }
+  if (resumable) {
+    dashboard_items_.push_back("Resume Game");
+    dashboard_actions_.push_back(DashboardAction::ResumeGame);
+  }
   dashboard_items_.push_back("Start Game");
   dashboard_actions_.push_back(DashboardAction::StartGame);
 
@@ -495,41 +638,47 @@ void App::ResetProgress() {
   progress_.settings.audio_enabled = keep_audio_enabled;
   last_unlocked_ = 0;
   ApplyProgressToLetterState();
-  last_reveal_tick_ = std::chrono::steady_clock::now();
+  timers_.Cancel(reveal_timer_);
   persistence_.Save(progress_);
   RefreshDashboardItems();
 }
 
-void App::LoadLetter() {
-  std::filesystem::path path = std::filesystem::current_path() / "assets" / "letter.txt";
-  std::ifstream file(path);
-  std::string content;
-  if (file.is_open()) {
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    content = buffer.str();
-  } else {
-    content = "Dear You,\n\nThis is a placeholder letter.\n\nWith love,\nMe";
-  }
-
-  auto chunks = SplitParagraphs(content);
+void App::LoadLetter(std::vector<std::string> paragraphs) {
   letter_chunks_.clear();
-  for (const auto& chunk : chunks) {
-    letter_chunks_.push_back(LetterChunk{chunk, 0u, false});
+  for (auto& chunk : paragraphs) {
+    letter_chunks_.push_back(LetterChunk{std::move(chunk), 0u, false});
   }
   ApplyProgressToLetterState();
   last_unlocked_ = progress_.unlocked_chunks;
-  last_reveal_tick_ = std::chrono::steady_clock::now();
-  UpdateLetterReveal();
+  timers_.Cancel(reveal_timer_);
+  PublishLetter();
 }
 
-void App::UpdateLetterReveal() {
-  auto now = std::chrono::steady_clock::now();
-  if (now - last_reveal_tick_ < std::chrono::milliseconds(50)) {
+void App::PublishLetter() {
+  std::vector<std::string> paragraphs;
+  paragraphs.reserve(letter_chunks_.size());
+  for (const auto& chunk : letter_chunks_) {
+    paragraphs.push_back(chunk.text);
+  }
+  render_prep_.SetLetter(std::move(paragraphs));
+}
+
+void App::ArmLetterReveal() {
+  // Steps only while the letter is drawn: each frame that shows it arms the
+  // next one, so the reveal pauses wherever the letter is off screen.
+  if (timers_.Pending(reveal_timer_)) {
     return;
   }
-  last_reveal_tick_ = now;
+  for (size_t i = 0; i < letter_chunks_.size(); ++i) {
+    const auto& chunk = letter_chunks_[i];
+    if (static_cast<int>(i) < progress_.unlocked_chunks && chunk.revealed < chunk.text.size()) {
+      reveal_timer_ = timers_.Schedule(TimerNow() + 50000, [this] { RevealLetterStep(); });
+      return;
+    }
+  }
+}
 
+void App::RevealLetterStep() {
   for (size_t i = 0; i < letter_chunks_.size(); ++i) {
     if (static_cast<int>(i) < progress_.unlocked_chunks) {
       auto& chunk = letter_chunks_[i];
@@ -544,19 +693,45 @@ void App::OnUnlock(int count) {
   progress_.unlocked_chunks = std::max(progress_.unlocked_chunks, capped);
 }
 
-void App::DrainGameEvents() {
-  GameEvent event;
-  while (game_.TryPopEvent(event)) {
-    if (event.type == GameEventType::UnlockChunk) {
-      OnUnlock(event.value);
+void App::DrainUiEvents() {
+  int unlocked_chunks = 0;
+  game_.Events().Poll(ui_events_, [&](const EngineEvent& event) {
+    if (const auto* unlocked = std::get_if<ChunkUnlocked>(&event)) {
+      unlocked_chunks = unlocked->unlocked_chunks;
     }
+  });
+  if (unlocked_chunks > 0) {
+    unlock_banner_chunk_ = unlocked_chunks;
+    show_unlock_banner_ = true;
+    timers_.Cancel(banner_timer_);
+    banner_timer_ = timers_.Schedule(TimerNow() + 2000000, [this] { show_unlock_banner_ = false; });
   }
 }
 
-void App::DrainAudioCommands() {
-  AudioCommand command;
-  while (game_.TryPopAudio(command)) {
-    audio_.PushCommand(command);
+void App::DrainProgressEvents() {
+  // Events wait in the bus until the save has loaded, so nothing is applied
+  // on top of defaults.
+  if (!progress_ready_) {
+    return;
+  }
+  int best_score = progress_.best_score;
+  int unlocked_chunks = 0;
+  game_.Events().Poll(progress_events_, [&](const EngineEvent& event) {
+    if (const auto* caught = std::get_if<NotesCaught>(&event)) {
+      best_score = std::max(best_score, caught->score);
+    } else if (const auto* chunk = std::get_if<ChunkUnlocked>(&event)) {
+      unlocked_chunks = std::max(unlocked_chunks, chunk->unlocked_chunks);
+    }
+  });
+  progress_.best_score = best_score;
+  const bool unlocked = unlocked_chunks > 0;
+  if (unlocked) {
+    OnUnlock(unlocked_chunks);
+  }
+  // Unlocks are rare and precious; write them through instead of waiting
+  // for exit.
+  if (unlocked) {
+    persistence_.Save(progress_);
   }
 }
 
@@ -564,4 +739,114 @@ void App::PushAudioEnabled(bool enabled) {
   audio_.PushCommand(AudioCommand{AudioCommandType::SetEnabled, enabled});
 }
 
+void App::DrainAssetUpdates() {
+  AssetUpdate update;
+  while (assets_.TryPopUpdate(update)) {
+    if (update.kind == AssetUpdate::Kind::Letter) {
+      ApplyLetterUpdate(std::move(update.paragraphs));
+    } else if (update.kind == AssetUpdate::Kind::Audio) {
+      audio_.PushCommand(AudioCommand{AudioCommandType::ReloadSounds, false});
+    }
+  }
+}
+
+void App::ApplyLetterUpdate(std::vector<std::string> paragraphs) {
+  // Unchanged paragraphs keep their chunk as is; an edited paragraph keeps
+  // the part of its reveal that still matches the new text.
+  std::vector<LetterChunk> chunks;
+  chunks.reserve(paragraphs.size());
+  for (size_t i = 0; i < paragraphs.size(); ++i) {
+    if (i < letter_chunks_.size() && letter_chunks_[i].text == paragraphs[i]) {
+      chunks.push_back(std::move(letter_chunks_[i]));
+      continue;
+    }
+    LetterChunk chunk{std::move(paragraphs[i]), 0u, false};
+    if (i < letter_chunks_.size()) {
+      const auto& old = letter_chunks_[i];
+      const auto mismatch = std::mismatch(old.text.begin(), old.text.end(), chunk.text.begin(),
+                                          chunk.text.end());
+      chunk.revealed = std::min(old.revealed, static_cast<size_t>(mismatch.first - old.text.begin()));
+    }
+    chunks.push_back(std::move(chunk));
+  }
+  letter_chunks_ = std::move(chunks);
+
+  // A paragraph removed mid-edit must not cost the player their progress.
+  const int unlocked = progress_.unlocked_chunks;
+  ApplyProgressToLetterState();
+  progress_.unlocked_chunks = std::max(progress_.unlocked_chunks, unlocked);
+  PublishLetter();
+}
+
+const PreparedFrame& App::AcquireFrame(bool board, bool letter) {
+  prep_settings_.board = board;
+  prep_settings_.backend = options_.board;
+  prep_settings_.sparkles = !governor_.AtLeast(QualityLevel::NoSparkles);
+  prep_settings_.letter_width = letter ? letter_width_ : 0;
+  prep_settings_.letter_shown.clear();
+  if (letter) {
+    for (size_t i = 0; i < letter_chunks_.size(); ++i) {
+      const auto& chunk = letter_chunks_[i];
+      prep_settings_.letter_shown.push_back(static_cast<int>(i) < progress_.unlocked_chunks
+                                                ? std::min(chunk.revealed, chunk.text.size())
+                                                : kLockedChunk);
+    }
+  }
+  return render_prep_.Acquire(prep_settings_);
+}
+
+void App::CollectInputTraces(const GameSnapshot& snapshot) {
+  if (!options_.latency_report) {
+    return;
+  }
+  game_.TakeInputTraces(pending_traces_);
+  const auto now = std::chrono::steady_clock::now();
+  // Traces applied after this snapshot was copied wait for the next frame.
+  auto visible = std::stable_partition(pending_traces_.begin(), pending_traces_.end(),
+                                       [&](const InputTrace& trace) {
+                                         return trace.id <= snapshot.last_input_id;
+                                       });
+  for (auto it = pending_traces_.begin(); it != visible; ++it) {
+    it->picked_up = now;
+    frame_traces_.push_back(*it);
+  }
+  pending_traces_.erase(pending_traces_.begin(), visible);
+}
+
+void App::MarkInputTracesFlushed() {
+  const auto now = std::chrono::steady_clock::now();
+  for (auto& trace : frame_traces_) {
+    trace.flushed = now;
+    latency_.Record(trace);
+  }
+  frame_traces_.clear();
+}
+
+std::uint64_t App::TimerNow() const {
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                        std::chrono::steady_clock::now() - timer_epoch_)
+                                        .count());
+}
+
+void App::RunDueTimers() {
+  // Anything due within a millisecond rides along on this wakeup rather than
+  // waking the UI thread again right after.
+  constexpr std::uint64_t kCoalesceUs = 1000;
+  timers_fired_ += timers_.Advance(TimerNow() + kCoalesceUs);
+}
+
+void App::PublishNextTimer() {
+  const auto next = timers_.NextDeadline();
+  const std::int64_t due = next ? static_cast<std::int64_t>(*next) : -1;
+  if (due == published_timer_us_) {
+    return;
+  }
+  published_timer_us_ = due;
+  {
+    std::lock_guard<std::mutex> lock(timer_mutex_);
+    next_timer_us_ = due;
+  }
+  timer_cv_.notify_one();
+}
+
 }  // namespace vday
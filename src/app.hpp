@@ -1,19 +1,35 @@
 #pragma once
 
-#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "asset_watch.hpp"
 #include "audio.hpp"
+#include "autopilot.hpp"
+#include "board.hpp"
 #include "game.hpp"
+#include "latency.hpp"
+#include "options.hpp"
 #include "persistence.hpp"
+#include "quality.hpp"
+#include "remote.hpp"
+#include "render_prep.hpp"
+#include "shm_ring.hpp"
+#include "spectator.hpp"
+#include "startup.hpp"
+#include "thread_tuning.hpp"
+#include "timer_wheel.hpp"
 
 namespace vday {
 
 class App {
  public:
-  App();
+  explicit App(const AppOptions& options = AppOptions{});
   void Run();
 
  private:
@@ -27,6 +43,7 @@ class App {
   };
 
   enum class DashboardAction {
+    ResumeGame,
     StartGame,
     Letter,
     Menu,
@@ -35,27 +52,76 @@ class App {
     Quit,
   };
 
+  // What the save-loading task hands back to the UI thread.
+  struct LoadedSave {
+    ProgressData progress;
+    std::vector<std::uint8_t> run;
+  };
+
   struct LetterChunk {
     std::string text;
     size_t revealed = 0;
     bool unlocked = false;
+    // The paragraph as last drawn, rebuilt only when what it shows changes.
+    ftxui::Element block = nullptr;
+    size_t block_shown = 0;
+    bool block_unlocked = false;
   };
 
   bool IsGameCompleted() const;
+  static bool RunInProgress(const GameSnapshot& snapshot);
   void RefreshDashboardItems();
   void ApplyProgressToLetterState();
   void ResetProgress();
-  void LoadLetter();
-  void UpdateLetterReveal();
+  void StartLoading();
+  void PollLoading(bool wait);
+  void LoadLetter(std::vector<std::string> paragraphs);
+  void PublishLetter();
+  void ArmLetterReveal();
+  void RevealLetterStep();
   void OnUnlock(int count);
-  void DrainGameEvents();
-  void DrainAudioCommands();
+  void DrainUiEvents();
+  void DrainProgressEvents();
   void PushAudioEnabled(bool enabled);
+  void DrainAssetUpdates();
+  void ApplyLetterUpdate(std::vector<std::string> paragraphs);
+  void CollectInputTraces(const GameSnapshot& snapshot);
+  void MarkInputTracesFlushed();
+  const PreparedFrame& AcquireFrame(bool board, bool letter);
+  std::uint64_t TimerNow() const;
+  void RunDueTimers();
+  void PublishNextTimer();
 
+  // Declared first so its clock starts before any other member is built.
+  StartupTrace startup_;
+  AppOptions options_;
   GameEngine game_;
   AudioEngine audio_;
+  AssetWatcher assets_;
+  SpectatorServer spectators_;
+  ShmSnapshotWriter snapshot_ring_;
   Persistence persistence_;
   ProgressData progress_;
+  std::future<LoadedSave> progress_future_;
+  std::future<std::vector<std::string>> letter_future_;
+  // GameEngine::SaveState record of a run saved by the previous launch.
+  std::vector<std::uint8_t> saved_run_;
+  bool progress_ready_ = false;
+  bool letter_ready_ = false;
+  Autopilot autopilot_;
+  // Draws the board and wraps the letter lines for each frame.
+  RenderPrep render_prep_{game_};
+  PrepSettings prep_settings_;
+  // Width the letter text was laid out at in the last frame.
+  int letter_width_ = 0;
+  // Letter chunk elements built from the prepared lines.
+  std::vector<LetterBlock> letter_blocks_;
+  // Reused so the steady state does not allocate: the dashboard's snapshot
+  // copy and every game frame's stats line.
+  GameSnapshot frame_snapshot_;
+  std::string stats_line_;
+  std::uint64_t frame_start_allocations_ = 0;
+  std::uint64_t frame_allocations_ = 0;
 
   Screen screen_ = Screen::Dashboard;
   std::vector<std::string> dashboard_items_;
@@ -65,7 +131,7 @@ class App {
 
   std::vector<LetterChunk> letter_chunks_;
   int last_unlocked_ = 0;
-  std::chrono::steady_clock::time_point last_reveal_tick_;
+  TimerWheel::Id reveal_timer_ = 0;
 
   std::vector<std::string> menu_items_;
   std::vector<std::string> menu_descriptions_;
@@ -73,6 +139,34 @@ class App {
 
   bool running_ = true;
   bool audio_requested_ = true;
+  // Independent subscriptions on the engine bus.
+  EngineBus::Subscription ui_events_ = 0;
+  EngineBus::Subscription progress_events_ = 0;
+  int unlock_banner_chunk_ = 0;
+  bool show_unlock_banner_ = false;
+  TimerWheel::Id banner_timer_ = 0;
+
+  LatencyRecorder latency_;
+  std::vector<InputTrace> pending_traces_;
+  std::vector<InputTrace> frame_traces_;
+
+  OutputMeter output_meter_;
+  FramePacer frame_pacer_;
+  QualityGovernor governor_;
+  std::uint64_t last_output_bytes_ = 0;
+  TimerWheel::Id frame_timer_ = 0;
+
+  // Every timed UI effect, in microseconds since timer_epoch_. Only the UI
+  // thread touches the wheel; the timer thread sleeps until the deadline
+  // published in next_timer_us_ and then wakes the UI thread once.
+  std::chrono::steady_clock::time_point timer_epoch_ = std::chrono::steady_clock::now();
+  TimerWheel timers_;
+  std::mutex timer_mutex_;
+  std::condition_variable timer_cv_;
+  std::int64_t next_timer_us_ = -1;       // guarded by timer_mutex_; -1 when idle
+  std::int64_t published_timer_us_ = -1;  // UI thread's copy
+  JitterStats timer_wake_jitter_;
+  size_t timers_fired_ = 0;
 };
 
 }  // namespace vday
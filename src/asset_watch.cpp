@@ -0,0 +1,152 @@
+#include "asset_watch.hpp"
+
+#include <cerrno>
+#include <cstdint>
+
+#include "letter.hpp"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace vday {
+
+namespace {
+
+#ifdef __linux__
+constexpr std::uint32_t kWatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE;
+// Editors save in bursts (truncate, write, rename); wait this long for quiet.
+constexpr int kDebounceMs = 50;
+
+bool EndsWith(const std::string& value, const std::string& suffix) {
+  return value.size() >= suffix.size() &&
+         value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+#endif
+
+}  // namespace
+
+AssetWatcher::AssetWatcher() = default;
+
+AssetWatcher::~AssetWatcher() {
+  Stop();
+}
+
+void AssetWatcher::Start(const std::filesystem::path& assets_dir) {
+  if (running_) {
+    return;
+  }
+#ifdef __linux__
+  wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (wake_fd_ < 0) {
+    return;
+  }
+  assets_dir_ = assets_dir;
+  running_ = true;
+  thread_ = std::thread(&AssetWatcher::RunLoop, this);
+#else
+  (void)assets_dir;
+#endif
+}
+
+void AssetWatcher::Stop() {
+  if (!running_) {
+    return;
+  }
+  running_ = false;
+#ifdef __linux__
+  const std::uint64_t one = 1;
+  (void)!write(wake_fd_, &one, sizeof(one));
+#endif
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+#ifdef __linux__
+  close(wake_fd_);
+  wake_fd_ = -1;
+#endif
+}
+
+bool AssetWatcher::TryPopUpdate(AssetUpdate& out) {
+  return updates_.TryPop(out);
+}
+
+size_t AssetWatcher::DroppedUpdates() const {
+  return updates_.Dropped();
+}
+
+void AssetWatcher::RunLoop() {
+#ifdef __linux__
+  const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd < 0) {
+    return;
+  }
+  const std::filesystem::path audio_dir = assets_dir_ / "audio";
+  const int assets_wd = inotify_add_watch(fd, assets_dir_.c_str(), kWatchMask);
+  int audio_wd = inotify_add_watch(fd, audio_dir.c_str(), kWatchMask);
+
+  bool letter_dirty = false;
+  bool audio_dirty = false;
+  alignas(inotify_event) char buffer[4096];
+  pollfd fds[2] = {{fd, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+
+  while (running_) {
+    const bool pending = letter_dirty || audio_dirty;
+    const int ready = poll(fds, 2, pending ? kDebounceMs : -1);
+    if (ready < 0) {
+      // A signal such as SIGWINCH can land on this thread; only a real error
+      // ends the watch.
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    if (fds[1].revents & POLLIN) {
+      break;
+    }
+    if (ready == 0) {
+      if (letter_dirty) {
+        AssetUpdate update;
+        update.kind = AssetUpdate::Kind::Letter;
+        std::string content;
+        if (ReadLetterFile(assets_dir_ / "letter.txt", content)) {
+          update.paragraphs = SplitParagraphs(content);
+          updates_.Push(update);
+        }
+      }
+      if (audio_dirty) {
+        updates_.Push(AssetUpdate{AssetUpdate::Kind::Audio, {}});
+      }
+      letter_dirty = false;
+      audio_dirty = false;
+      continue;
+    }
+
+    ssize_t length = 0;
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+      for (char* ptr = buffer; ptr < buffer + length;) {
+        const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+        ptr += sizeof(inotify_event) + event->len;
+        const std::string name = event->len > 0 ? event->name : "";
+        if (event->wd == assets_wd) {
+          if (name == "letter.txt") {
+            letter_dirty = true;
+          } else if (name == "audio" && (event->mask & IN_ISDIR) &&
+                     (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+            audio_wd = inotify_add_watch(fd, audio_dir.c_str(), kWatchMask);
+            audio_dirty = true;
+          }
+        } else if (event->wd == audio_wd && EndsWith(name, ".wav")) {
+          audio_dirty = true;
+        }
+      }
+    }
+  }
+  close(fd);
+#endif
+}
+
+}  // namespace vday
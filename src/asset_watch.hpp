@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "thread_queue.hpp"
+
+namespace vday {
+
+struct AssetUpdate {
+  enum class Kind {
+    Letter,
+    Audio,
+  };
+  Kind kind = Kind::Letter;
+  // For Letter updates: the new letter, already split into paragraphs.
+  std::vector<std::string> paragraphs;
+};
+
+// Watches assets/ and assets/audio/ with inotify on its own thread. Letter
+// edits are read and split there, so consumers only pick up finished updates.
+// A no-op on platforms without inotify.
+class AssetWatcher {
+ public:
+  AssetWatcher();
+  ~AssetWatcher();
+
+  void Start(const std::filesystem::path& assets_dir);
+  void Stop();
+
+  bool TryPopUpdate(AssetUpdate& out);
+  // Updates discarded because nobody collected them in time.
+  size_t DroppedUpdates() const;
+
+ private:
+  void RunLoop();
+
+  std::filesystem::path assets_dir_;
+  std::atomic<bool> running_{false};
+  std::thread thread_;
+  int wake_fd_ = -1;
+  // Only the latest letter matters, so a backlog sheds its oldest entries.
+  ThreadSafeQueue<AssetUpdate> updates_{16, OverflowPolicy::DropOldest};
+};
+
+}  // namespace vday
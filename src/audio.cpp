@@ -1,16 +1,23 @@
 #include "audio.hpp"
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
+#include <variant>
+#include <vector>
 
 #ifdef HAVE_SDL2_MIXER
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
+
+#include "sfx.hpp"
 #endif
 
 namespace vday {
 
-AudioEngine::AudioEngine() = default;
+// Stale sound effects are worthless, so a backed-up queue sheds the oldest.
+AudioEngine::AudioEngine() : queue_(256, OverflowPolicy::DropOldest) {}
 
 AudioEngine::~AudioEngine() {
   Stop();
@@ -21,6 +28,18 @@ void AudioEngine::Start() {
     return;
   }
   running_ = true;
+  queue_.Reopen();
+  if (bus_) {
+    // Runs on the engine thread for every publish, so it only flags and
+    // wakes: nothing is queued or allocated, and a burst of engine events
+    // costs the audio thread one poll.
+    subscription_ = bus_->Subscribe([this] {
+      if (!wake_pending_.exchange(true)) {
+        wake_requested_ = std::chrono::steady_clock::now().time_since_epoch().count();
+        queue_.Wake();
+      }
+    });
+  }
   thread_ = std::thread(&AudioEngine::RunLoop, this);
 }
 
@@ -29,17 +48,48 @@ void AudioEngine::Stop() {
     return;
   }
   running_ = false;
-  queue_.Push(AudioCommand{AudioCommandType::Stop, false});
+  if (bus_) {
+    bus_->Unsubscribe(subscription_);
+  }
+  queue_.Close();
   if (thread_.joinable()) {
     thread_.join();
   }
 }
 
 void AudioEngine::PushCommand(const AudioCommand& command) {
-  queue_.Push(command);
+  AudioCommand stamped = command;
+  stamped.queued = std::chrono::steady_clock::now();
+  queue_.Push(stamped);
+}
+
+void AudioEngine::Attach(EngineBus& bus) {
+  bus_ = &bus;
+}
+
+void AudioEngine::SetStartupTrace(StartupTrace* trace) {
+  startup_trace_ = trace;
+}
+
+void AudioEngine::SetThreadTuning(const ThreadTuning& tuning) {
+  thread_tuning_ = tuning;
+}
+
+const std::string& AudioEngine::ThreadSummary() const {
+  return thread_summary_;
+}
+
+const JitterStats& AudioEngine::WakeJitter() const {
+  return wake_jitter_;
+}
+
+size_t AudioEngine::DroppedCommands() const {
+  return queue_.Dropped();
 }
 
 void AudioEngine::RunLoop() {
+  thread_summary_ = ApplyThreadTuning("audio", thread_tuning_);
+  wake_jitter_.Clear();
   bool enabled = true;
 
 #ifdef HAVE_SDL2_MIXER
@@ -59,20 +109,98 @@ void AudioEngine::RunLoop() {
   Mix_Chunk* miss_sfx = nullptr;
   Mix_Chunk* unlock_sfx = nullptr;
 
-  if (std::filesystem::exists(catch_path)) {
-    catch_sfx = Mix_LoadWAV(catch_path.string().c_str());
-  }
-  if (std::filesystem::exists(miss_path)) {
-    miss_sfx = Mix_LoadWAV(miss_path.string().c_str());
+  // Decodes first and swaps after, so a sound is never missing mid-reload and
+  // a file that fails to load keeps the previous sound.
+  auto reload = [](const std::filesystem::path& path, Mix_Chunk*& slot) {
+    if (!std::filesystem::exists(path)) {
+      return;
+    }
+    Mix_Chunk* fresh = Mix_LoadWAV(path.string().c_str());
+    if (!fresh) {
+      return;
+    }
+    Mix_Chunk* old = slot;
+    slot = fresh;
+    if (old) {
+      Mix_FreeChunk(old);
+    }
+  };
+  auto reload_all = [&] {
+    reload(catch_path, catch_sfx);
+    reload(miss_path, miss_sfx);
+    reload(unlock_path, unlock_sfx);
+  };
+  reload_all();
+
+  // Missing WAVs fall back to synthesized effects. Mix_QuickLoad_RAW borrows
+  // the buffers, so they live until the thread exits.
+  std::vector<std::int16_t> synth_buffers[3];
+  int frequency = 0;
+  Uint16 format = 0;
+  int channels = 0;
+  if (Mix_QuerySpec(&frequency, &format, &channels) != 0 && format == AUDIO_S16SYS) {
+    auto synthesize = [&](SoundEffect effect, std::vector<std::int16_t>& buffer, Mix_Chunk*& slot) {
+      if (slot) {
+        return;
+      }
+      buffer = SynthesizeEffect(effect, frequency, channels);
+      slot = Mix_QuickLoad_RAW(reinterpret_cast<Uint8*>(buffer.data()),
+                               static_cast<Uint32>(buffer.size() * sizeof(std::int16_t)));
+    };
+    synthesize(SoundEffect::Catch, synth_buffers[0], catch_sfx);
+    synthesize(SoundEffect::Miss, synth_buffers[1], miss_sfx);
+    synthesize(SoundEffect::Unlock, synth_buffers[2], unlock_sfx);
   }
-  if (std::filesystem::exists(unlock_path)) {
-    unlock_sfx = Mix_LoadWAV(unlock_path.string().c_str());
+#endif
+  if (startup_trace_) {
+    startup_trace_->Mark("audio ready");
   }
+
+  auto play = [&](AudioCommandType type) {
+#ifdef HAVE_SDL2_MIXER
+    if (!enabled) {
+      return;
+    }
+    if (type == AudioCommandType::PlayCatch && catch_sfx) {
+      Mix_PlayChannel(-1, catch_sfx, 0);
+    } else if (type == AudioCommandType::PlayMiss && miss_sfx) {
+      Mix_PlayChannel(-1, miss_sfx, 0);
+    } else if (type == AudioCommandType::PlayUnlock && unlock_sfx) {
+      Mix_PlayChannel(-1, unlock_sfx, 0);
+    }
+#else
+    (void)type;
+    (void)enabled;
 #endif
+  };
 
+  AudioCommand command;
   while (running_) {
-    AudioCommand command;
-    queue_.WaitPop(command);
+    const bool popped = queue_.WaitPopOrWake(command);
+    // Cleared before polling so a publish racing with the poll wakes us again.
+    if (wake_pending_.exchange(false)) {
+      const std::chrono::steady_clock::time_point requested{
+          std::chrono::steady_clock::duration(wake_requested_.load())};
+      wake_jitter_.Add(std::chrono::steady_clock::now() - requested);
+      // Sounds are played after the poll so the bus is not held while
+      // mixing; in event order, as the engine published them.
+      bus_sounds_.clear();
+      bus_->Poll(subscription_, [this](const EngineEvent& event) {
+        if (std::holds_alternative<NotesCaught>(event)) {
+          bus_sounds_.push_back(AudioCommandType::PlayCatch);
+        } else if (std::holds_alternative<NotesMissed>(event)) {
+          bus_sounds_.push_back(AudioCommandType::PlayMiss);
+        } else if (std::holds_alternative<ChunkUnlocked>(event)) {
+          bus_sounds_.push_back(AudioCommandType::PlayUnlock);
+        }
+      });
+      for (const AudioCommandType sound : bus_sounds_) {
+        play(sound);
+      }
+    }
+    if (!popped) {
+      continue;
+    }
     if (command.type == AudioCommandType::Stop) {
       break;
     }
@@ -80,21 +208,13 @@ void AudioEngine::RunLoop() {
       enabled = command.enabled;
       continue;
     }
-
+    if (command.type == AudioCommandType::ReloadSounds) {
 #ifdef HAVE_SDL2_MIXER
-    if (!enabled) {
+      reload_all();
+#endif
       continue;
     }
-    if (command.type == AudioCommandType::PlayCatch && catch_sfx) {
-      Mix_PlayChannel(-1, catch_sfx, 0);
-    } else if (command.type == AudioCommandType::PlayMiss && miss_sfx) {
-      Mix_PlayChannel(-1, miss_sfx, 0);
-    } else if (command.type == AudioCommandType::PlayUnlock && unlock_sfx) {
-      Mix_PlayChannel(-1, unlock_sfx, 0);
-    }
-#else
-    (void)enabled;
-#endif
+    play(command.type);
   }
 
 #ifdef HAVE_SDL2_MIXER
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "game.hpp"
+#include "startup.hpp"
 #include "thread_queue.hpp"
+#include "thread_tuning.hpp"
 
 namespace vday {
 
@@ -18,6 +22,20 @@ class AudioEngine {
   void Stop();
 
   void PushCommand(const AudioCommand& command);
+  // Plays the catch, miss and unlock sounds for events published on `bus`.
+  // Call before Start(); the bus must outlive this engine.
+  void Attach(EngineBus& bus);
+  // Marks "audio ready" once the device is open and sounds are decoded.
+  void SetStartupTrace(StartupTrace* trace);
+  // Takes effect on the next Start().
+  void SetThreadTuning(const ThreadTuning& tuning);
+
+  // What the last Start() managed to apply, and how long play commands
+  // waited for the audio thread. Read after Stop().
+  const std::string& ThreadSummary() const;
+  const JitterStats& WakeJitter() const;
+  // Commands shed because the bounded command queue was full.
+  size_t DroppedCommands() const;
 
  private:
   void RunLoop();
@@ -25,6 +43,17 @@ class AudioEngine {
   std::atomic<bool> running_{false};
   std::thread thread_;
   ThreadSafeQueue<AudioCommand> queue_;
+  StartupTrace* startup_trace_ = nullptr;
+  EngineBus* bus_ = nullptr;
+  EngineBus::Subscription subscription_ = 0;
+  // Set by the bus hook; the audio thread clears it and drains the bus.
+  std::atomic<bool> wake_pending_{false};
+  std::atomic<std::chrono::steady_clock::rep> wake_requested_{0};
+  // Sounds drained from the bus, reused across polls.
+  std::vector<AudioCommandType> bus_sounds_;
+  ThreadTuning thread_tuning_;
+  std::string thread_summary_;
+  JitterStats wake_jitter_;
 };
 
 }  // namespace vday
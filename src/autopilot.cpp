@@ -0,0 +1,105 @@
+#include "autopilot.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace vday {
+
+namespace {
+
+// A good item is worth its score plus the streak a miss would cost.
+constexpr int kMissPenalty = 10;
+
+int PlanWeight(ItemType type) {
+  const int score = ItemScore(type);
+  return score > 0 ? score + kMissPenalty : score;
+}
+
+}  // namespace
+
+Autopilot::Autopilot(int lookahead_rows) : lookahead_rows_(std::max(1, lookahead_rows)) {}
+
+bool Autopilot::Decide(const GameSnapshot& snapshot, InputAction& out) {
+  if (snapshot.paused || snapshot.notes.empty()) {
+    return false;
+  }
+  const int min_x = MinPlayerX(snapshot.width);
+  const int positions = MaxPlayerX(snapshot.width) - min_x + 1;
+  const int catcher_row = CatcherRow(snapshot.height);
+  // Same step StepSimulation uses, so arrival ticks match exactly.
+  const std::int32_t fall_per_tick = NoteFallPerTick(snapshot.tick_rate);
+  const std::int64_t lookahead = std::int64_t{lookahead_rows_} * kNoteRowUnits;
+  const int horizon = static_cast<int>(
+      std::clamp<std::int64_t>((lookahead + fall_per_tick - 1) / fall_per_tick, 1, kMaxHorizonTicks));
+
+  gain_.assign(static_cast<size_t>(horizon + 1) * positions, 0);
+  int last_due = 0;
+  const int first_row = catcher_row - lookahead_rows_ - 1;
+  for (const auto& note : NotesInRows(snapshot.notes, first_row, std::numeric_limits<int>::max())) {
+    Note next = note;
+    for (int tick = 1; tick <= horizon; ++tick) {
+      next.y += fall_per_tick;
+      if (NoteRow(next) < catcher_row) {
+        continue;
+      }
+      const int weight = PlanWeight(note.type);
+      for (int p = 0; p < positions; ++p) {
+        if (CatcherCatches(min_x + p, snapshot.width, note)) {
+          gain_[static_cast<size_t>(tick) * positions + p] += weight;
+        }
+      }
+      last_due = std::max(last_due, tick);
+      break;
+    }
+  }
+  if (last_due == 0) {
+    return false;
+  }
+
+  left_.resize(positions);
+  right_.resize(positions);
+  for (int p = 0; p < positions; ++p) {
+    left_[p] = MovePlayer(min_x + p, snapshot.width, InputAction::MoveLeft) - min_x;
+    right_[p] = MovePlayer(min_x + p, snapshot.width, InputAction::MoveRight) - min_x;
+  }
+
+  // value_[t][p]: best total from tick t onwards when the catcher is at p
+  // during tick t. Nothing lands after last_due, so that row is the boundary.
+  value_.assign(static_cast<size_t>(last_due + 2) * positions, 0);
+  for (int tick = last_due; tick >= 1; --tick) {
+    const int* next = &value_[static_cast<size_t>(tick + 1) * positions];
+    int* current = &value_[static_cast<size_t>(tick) * positions];
+    const int* gain = &gain_[static_cast<size_t>(tick) * positions];
+    for (int p = 0; p < positions; ++p) {
+      current[p] = gain[p] + std::max({next[p], next[left_[p]], next[right_[p]]});
+    }
+  }
+
+  const int start = std::clamp(snapshot.player_x - min_x, 0, positions - 1);
+  const int* first = &value_[static_cast<size_t>(positions)];
+  const int stay_value = first[start];
+  const int left_value = first[left_[start]];
+  const int right_value = first[right_[start]];
+  if (left_value > stay_value && left_value >= right_value) {
+    out = InputAction::MoveLeft;
+    return true;
+  }
+  if (right_value > stay_value) {
+    out = InputAction::MoveRight;
+    return true;
+  }
+  return false;
+}
+
+void Autopilot::Drive(GameEngine& engine, const GameSnapshot& snapshot) {
+  if (snapshot.tick == driven_tick_) {
+    return;
+  }
+  driven_tick_ = snapshot.tick;
+  InputAction action;
+  if (Decide(snapshot, action)) {
+    engine.PushInput(action);
+  }
+}
+
+}  // namespace vday
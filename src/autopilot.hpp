@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "game.hpp"
+
+namespace vday {
+
+// Plans catcher moves over the notes due within the next few rows. Each tick
+// the catcher can stay or make one move; a backward DP over (tick, column)
+// maximises the value of the notes it will be under when they land, counting
+// misses against good items and BrokenHeart catches against the score.
+class Autopilot {
+ public:
+  explicit Autopilot(int lookahead_rows = 8);
+
+  // Picks the move to make before the next tick. Returns false to stay put.
+  bool Decide(const GameSnapshot& snapshot, InputAction& out);
+  // Decides and pushes the move, once per simulated tick: the plan allows one
+  // move per tick, so further frames showing the same tick do nothing.
+  void Drive(GameEngine& engine, const GameSnapshot& snapshot);
+
+ private:
+  static constexpr int kMaxHorizonTicks = 512;
+
+  int lookahead_rows_;
+  std::uint64_t driven_tick_ = ~std::uint64_t{0};
+  // Scratch buffers reused across calls: [tick * positions + column].
+  std::vector<int> gain_;
+  std::vector<int> value_;
+  std::vector<int> left_;
+  std::vector<int> right_;
+};
+
+}  // namespace vday
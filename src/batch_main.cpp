@@ -0,0 +1,270 @@
+// vday_batch: runs many seeded headless games across all cores and reports
+// score, miss and time-to-unlock distributions for balancing.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "autopilot.hpp"
+#include "game.hpp"
+#include "letter.hpp"
+
+namespace {
+
+struct BatchOptions {
+  long games = 10000;
+  int threads = 0;
+  int minutes = 5;
+  int tick_rate = vday::kDefaultTickRate;
+  std::uint32_t seed = 1;
+  bool autopilot = true;
+  int chunks = 0;
+};
+
+// Fixed-width bucket histogram over [min_value, min_value + width * count),
+// owned by one worker and merged after the join. Values outside the range go
+// to the first or last bucket.
+class Histogram {
+ public:
+  Histogram(int min_value, int bucket_width, int bucket_count)
+      : min_value_(min_value),
+        bucket_width_(bucket_width),
+        buckets_(static_cast<size_t>(bucket_count), 0) {}
+
+  void Add(int value) {
+    const std::int64_t offset = std::int64_t{value} - min_value_;
+    const auto index = static_cast<size_t>(std::clamp<std::int64_t>(
+        offset / bucket_width_, 0, static_cast<std::int64_t>(buckets_.size()) - 1));
+    buckets_[index]++;
+    count_++;
+    sum_ += value;
+  }
+
+  void Merge(const Histogram& other) {
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+      buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+  }
+
+  std::uint64_t count() const { return count_; }
+  double Mean() const { return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+
+  // Lower edge of the bucket holding the p-th quantile.
+  int Percentile(double p) const {
+    if (count_ == 0) {
+      return 0;
+    }
+    const auto target = static_cast<std::uint64_t>(p * static_cast<double>(count_ - 1));
+    std::uint64_t seen = 0;
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+      seen += buckets_[i];
+      if (seen > target) {
+        return min_value_ + static_cast<int>(i) * bucket_width_;
+      }
+    }
+    return min_value_ + static_cast<int>(buckets_.size() - 1) * bucket_width_;
+  }
+
+ private:
+  int min_value_;
+  int bucket_width_;
+  std::vector<std::uint64_t> buckets_;
+  std::uint64_t count_ = 0;
+  std::int64_t sum_ = 0;
+};
+
+struct WorkerStats {
+  // BrokenHeart catches can leave a game below zero.
+  explicit WorkerStats(int chunks) : score(-10000, 25, 4400), misses(0, 1, 2000) {
+    for (int i = 0; i < chunks; ++i) {
+      unlock_seconds.emplace_back(0, 1, 24 * 3600);
+    }
+  }
+
+  void Merge(const WorkerStats& other) {
+    score.Merge(other.score);
+    misses.Merge(other.misses);
+    for (size_t i = 0; i < unlock_seconds.size(); ++i) {
+      unlock_seconds[i].Merge(other.unlock_seconds[i]);
+    }
+    games += other.games;
+  }
+
+  Histogram score;
+  Histogram misses;
+  std::vector<Histogram> unlock_seconds;
+  long games = 0;
+};
+
+int LetterChunkCount() {
+  std::ifstream file(std::filesystem::current_path() / "assets" / "letter.txt");
+  if (!file.is_open()) {
+    return 3;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  return std::max(1, static_cast<int>(vday::SplitParagraphs(buffer.str()).size()));
+}
+
+void RunGame(const BatchOptions& options, std::uint32_t seed, vday::GameEngine& engine,
+             vday::EngineBus::Subscription subscription, vday::Autopilot& autopilot,
+             vday::GameSnapshot& snapshot, WorkerStats& stats) {
+  engine.Reset();
+  engine.Seed(seed);
+  const long total_ticks = static_cast<long>(options.minutes) * 60 * options.tick_rate;
+  int unlocked = 0;
+  for (long tick = 1; tick <= total_ticks; ++tick) {
+    if (options.autopilot) {
+      engine.SnapshotInto(snapshot);
+      autopilot.Drive(engine, snapshot);
+    }
+    engine.RunTicks(1);
+
+    engine.Events().Poll(subscription, [&](const vday::EngineEvent& event) {
+      const auto* unlock = std::get_if<vday::ChunkUnlocked>(&event);
+      if (!unlock) {
+        return;
+      }
+      const int reached = std::min(unlock->unlocked_chunks, options.chunks);
+      for (; unlocked < reached; ++unlocked) {
+        stats.unlock_seconds[static_cast<size_t>(unlocked)].Add(
+            static_cast<int>(tick / options.tick_rate));
+      }
+    });
+  }
+
+  engine.SnapshotInto(snapshot);
+  stats.score.Add(snapshot.score);
+  stats.misses.Add(snapshot.misses);
+  stats.games++;
+}
+
+bool ParseArg(const std::string& arg, const std::string& name, long& out) {
+  const std::string prefix = name + "=";
+  if (arg.compare(0, prefix.size(), prefix) != 0) {
+    return false;
+  }
+  try {
+    out = std::stol(arg.substr(prefix.size()));
+  } catch (...) {
+    std::cerr << "Invalid value for " << name << "\n";
+  }
+  return true;
+}
+
+BatchOptions ParseBatchOptions(int argc, char** argv) {
+  BatchOptions options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    long value = 0;
+    if (ParseArg(arg, "--games", options.games)) {
+      continue;
+    }
+    if (ParseArg(arg, "--threads", value)) {
+      options.threads = static_cast<int>(value);
+    } else if (ParseArg(arg, "--minutes", value)) {
+      options.minutes = static_cast<int>(value);
+    } else if (ParseArg(arg, "--tick-rate", value)) {
+      options.tick_rate = static_cast<int>(value);
+    } else if (ParseArg(arg, "--seed", value)) {
+      options.seed = static_cast<std::uint32_t>(value);
+    } else if (ParseArg(arg, "--chunks", value)) {
+      options.chunks = static_cast<int>(value);
+    } else if (arg == "--idle") {
+      options.autopilot = false;
+    } else {
+      std::cerr << "Unknown option: " << arg << "\n";
+    }
+  }
+  if (options.threads <= 0) {
+    options.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  }
+  if (options.chunks <= 0) {
+    options.chunks = LetterChunkCount();
+  }
+  options.minutes = std::max(1, options.minutes);
+  options.tick_rate = std::clamp(options.tick_rate, 1, 1000);
+  return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const BatchOptions options = ParseBatchOptions(argc, argv);
+
+  // Workers claim seeds in small blocks so uneven games still balance out.
+  constexpr long kSeedBlock = 16;
+  std::atomic<long> next_game{0};
+  std::vector<WorkerStats> results(static_cast<size_t>(options.threads), WorkerStats(options.chunks));
+  std::vector<std::thread> workers;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < options.threads; ++t) {
+    workers.emplace_back([&, t] {
+      WorkerStats stats(options.chunks);
+      vday::GameEngine engine;
+      engine.SetTickRate(options.tick_rate);
+      // Nothing rewinds a headless game.
+      engine.SetCheckpointInterval(0);
+      const auto subscription = engine.Events().Subscribe();
+      vday::Autopilot autopilot;
+      vday::GameSnapshot snapshot;
+      while (true) {
+        const long first = next_game.fetch_add(kSeedBlock, std::memory_order_relaxed);
+        if (first >= options.games) {
+          break;
+        }
+        const long last = std::min(options.games, first + kSeedBlock);
+        for (long game = first; game < last; ++game) {
+          RunGame(options, options.seed + static_cast<std::uint32_t>(game), engine, subscription,
+                  autopilot, snapshot, stats);
+        }
+      }
+      results[static_cast<size_t>(t)] = std::move(stats);
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  WorkerStats total(options.chunks);
+  for (const auto& stats : results) {
+    total.Merge(stats);
+  }
+
+  const double games_per_second = static_cast<double>(total.games) / std::max(seconds, 1e-9);
+  std::printf("%ld games x %d play-minutes, %s, %d threads, %.2f s\n", total.games, options.minutes,
+              options.autopilot ? "autopilot" : "idle", options.threads, seconds);
+  std::printf("throughput: %.0f games/s, %.0f games/s/core\n", games_per_second,
+              games_per_second / options.threads);
+  std::printf("score:   mean %.1f  p10 %d  p50 %d  p90 %d  p99 %d\n", total.score.Mean(),
+              total.score.Percentile(0.10), total.score.Percentile(0.50),
+              total.score.Percentile(0.90), total.score.Percentile(0.99));
+  std::printf("misses:  mean %.1f  p10 %d  p50 %d  p90 %d  p99 %d\n", total.misses.Mean(),
+              total.misses.Percentile(0.10), total.misses.Percentile(0.50),
+              total.misses.Percentile(0.90), total.misses.Percentile(0.99));
+  std::printf("time to unlock (play-minutes):\n");
+  for (size_t i = 0; i < total.unlock_seconds.size(); ++i) {
+    const auto& hist = total.unlock_seconds[i];
+    const double reached =
+        total.games ? 100.0 * static_cast<double>(hist.count()) / static_cast<double>(total.games) : 0.0;
+    std::printf("  chunk %2zu: reached %5.1f%%  p50 %6.2f  p90 %6.2f  p99 %6.2f\n", i + 1, reached,
+                hist.Percentile(0.50) / 60.0, hist.Percentile(0.90) / 60.0,
+                hist.Percentile(0.99) / 60.0);
+  }
+  return 0;
+}
@@ -0,0 +1,260 @@
+#include "board.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <memory>
+#include <string>
+
+#include <ftxui/dom/canvas.hpp>
+#include <ftxui/dom/node.hpp>
+
+namespace vday {
+
+namespace {
+
+constexpr std::string_view kTopLeft = "\xE2\x94\x8C";      // ┌
+constexpr std::string_view kTopRight = "\xE2\x94\x90";     // ┐
+constexpr std::string_view kBottomLeft = "\xE2\x94\x94";   // └
+constexpr std::string_view kBottomRight = "\xE2\x94\x98";  // ┘
+constexpr std::string_view kHorizontal = "\xE2\x94\x80";   // ─
+constexpr std::string_view kVertical = "\xE2\x94\x82";     // │
+
+// Render colors, indexed by ItemType; the simulation core stays free of FTXUI.
+constexpr std::array<ftxui::Color::Palette16, kItemTypeCount> kItemColors = {
+    ftxui::Color::RedLight,      // Heart
+    ftxui::Color::YellowLight,   // LoveNote
+    ftxui::Color::MagentaLight,  // Kiss
+    ftxui::Color::GrayLight,     // BrokenHeart
+};
+
+ftxui::Color ItemColor(ItemType type) {
+  return kItemColors[static_cast<size_t>(type)];
+}
+
+// Where the simulation will have moved a note by the time this frame shows,
+// kept above the catcher row so the glyph never overlaps the catcher.
+float InterpolatedNoteY(const GameSnapshot& snapshot, const Note& note) {
+  const int catcher_row = CatcherRow(snapshot.height);
+  const float y = NoteRows(note);
+  if (NoteRow(note) >= catcher_row) {
+    return y;
+  }
+  const float lead = snapshot.interpolation_alpha *
+                     static_cast<float>(NoteFallPerTick(snapshot.tick_rate)) / kNoteRowUnits;
+  return std::min(y + lead, static_cast<float>(catcher_row) - 0.001f);
+}
+
+int NoteColumn(const GameSnapshot& snapshot, const Note& note) {
+  const int max_note_x = std::max(0, snapshot.width - ItemVisualWidth(note.type));
+  return 1 + std::clamp(note.x, 0, max_note_x);
+}
+
+// Copies every board pixel into the Screen each frame: FTXUI clears the Screen
+// after each flush, so there is no previous frame to diff against here. The
+// terminal diff stays with FTXUI.
+class CellBoardNode : public ftxui::Node {
+ public:
+  explicit CellBoardNode(const CellBoard* board) : board_(board) {}
+
+  void ComputeRequirement() override {
+    requirement_.min_x = board_->columns();
+    requirement_.min_y = board_->rows();
+  }
+
+  void Render(ftxui::Screen& screen) override {
+    const int columns = std::min(board_->columns(), box_.x_max - box_.x_min + 1);
+    const int rows = std::min(board_->rows(), box_.y_max - box_.y_min + 1);
+    for (int y = 0; y < rows; ++y) {
+      for (int x = 0; x < columns; ++x) {
+        screen.PixelAt(box_.x_min + x, box_.y_min + y) = board_->PixelAt(x, y);
+      }
+    }
+  }
+
+ private:
+  const CellBoard* board_;
+};
+
+// Fills `out` with left, `count` copies of fill, then right. `out` keeps its
+// buffer, so redrawing a board of the same width does not allocate.
+void BorderLine(std::string& out, std::string_view left, std::string_view fill,
+                std::string_view right, int count) {
+  out.assign(left);
+  for (int i = 0; i < count; ++i) {
+    out += fill;
+  }
+  out += right;
+}
+
+}  // namespace
+
+ftxui::Element RenderGameCanvas(const GameSnapshot& snapshot, bool sparkles) {
+  using namespace ftxui;
+  constexpr int kCanvasCellWidth = 2;
+  constexpr int kCanvasCellHeight = 4;
+  auto cx = [&](int cell_x) { return cell_x * kCanvasCellWidth; };
+  auto cy = [&](int cell_y) { return cell_y * kCanvasCellHeight; };
+
+  Canvas canvas((snapshot.width + 2) * kCanvasCellWidth,
+                (snapshot.height + 2) * kCanvasCellHeight);
+
+  thread_local std::string top;
+  thread_local std::string bottom;
+  BorderLine(top, kTopLeft, kHorizontal, kTopRight, snapshot.width);
+  BorderLine(bottom, kBottomLeft, kHorizontal, kBottomRight, snapshot.width);
+  canvas.DrawText(cx(0), cy(0), top);
+  for (int y = 1; y <= snapshot.height; ++y) {
+    canvas.DrawText(cx(0), cy(y), "\xE2\x94\x82");  // │
+    canvas.DrawText(cx(snapshot.width + 1), cy(y), "\xE2\x94\x82");  // │
+  }
+  canvas.DrawText(cx(0), cy(snapshot.height + 1), bottom);
+
+  // Notes are drawn at their interpolated position, so a low tick rate still
+  // scrolls smoothly. The fractional row drives a braille trail in the cell
+  // above each glyph; trails go first so glyphs overwrite them where they meet.
+  // A note part way into row -1 truncates to row 0, so that row is included.
+  const auto notes = NotesInRows(snapshot.notes, -1, snapshot.height);
+  for (const auto& note : notes) {
+    const float y_pos = InterpolatedNoteY(snapshot, note);
+    const int y = static_cast<int>(y_pos);
+    if (y < 1 || y >= snapshot.height) {
+      continue;
+    }
+    const int sub_row = static_cast<int>((y_pos - static_cast<float>(y)) * kCanvasCellHeight);
+    const int trail_x = cx(NoteColumn(snapshot, note));
+    for (int px = 0; px < ItemVisualWidth(note.type) * kCanvasCellWidth; ++px) {
+      canvas.DrawPoint(trail_x + px, cy(y) + sub_row, true, Color::GrayDark);
+    }
+  }
+
+  for (const auto& note : notes) {
+    int y = static_cast<int>(InterpolatedNoteY(snapshot, note));
+    if (y < 0 || y >= snapshot.height) {
+      continue;
+    }
+    const ItemInfo& item = Item(note.type);
+    // Glyphs fit the small-string buffer, so this string never allocates.
+    canvas.DrawText(cx(NoteColumn(snapshot, note)), cy(1 + y), std::string(item.glyph),
+                    ItemColor(note.type));
+  }
+
+  int catcher_y = 1 + CatcherRow(snapshot.height);
+  int start_x = 1 + CatcherStartColumn(snapshot.player_x, snapshot.width);
+  const bool catcher_flash = snapshot.catcher_flash_frames > 0;
+  const Color catcher_color = catcher_flash ? Color::YellowLight : Color::CyanLight;
+  // Draw catcher as a single token to avoid terminal-specific per-cell artifacts.
+  canvas.DrawText(cx(start_x), cy(catcher_y), "|___|", catcher_color);
+  if (sparkles && catcher_flash && catcher_y > 1) {
+    const std::string sparkle = (snapshot.catcher_flash_frames % 2 == 0) ? " * " : " + ";
+    canvas.DrawText(cx(start_x + 1), cy(catcher_y - 1), sparkle, Color::White);
+  }
+  return ftxui::canvas(std::move(canvas));
+}
+
+void FormatScoreLine(const GameSnapshot& snapshot, std::string& out) {
+  out.clear();
+  AppendStat(out, "Score: ", snapshot.score);
+  AppendStat(out, "  Streak: ", snapshot.streak);
+  AppendStat(out, "  Misses: ", snapshot.misses);
+}
+
+void AppendStat(std::string& out, std::string_view label, long value) {
+  char digits[24];
+  const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+  out += label;
+  out.append(digits, result.ptr);
+}
+
+void CellBoard::Update(const GameSnapshot& snapshot, bool sparkles) {
+  const int columns = snapshot.width + 2;
+  const int rows = snapshot.height + 2;
+  const size_t size = static_cast<size_t>(columns) * static_cast<size_t>(rows);
+  bool resized = false;
+  if (columns != columns_ || rows != rows_) {
+    columns_ = columns;
+    rows_ = rows;
+    cells_.assign(size, Cell{});
+    next_.assign(size, Cell{});
+    pixels_.assign(size, ftxui::Pixel{});
+    resized = true;
+  }
+  std::fill(next_.begin(), next_.end(), Cell{});
+
+  const ftxui::Color border = ftxui::Color::Default;
+  Put(0, 0, kTopLeft, border);
+  Put(columns - 1, 0, kTopRight, border);
+  Put(0, rows - 1, kBottomLeft, border);
+  Put(columns - 1, rows - 1, kBottomRight, border);
+  for (int x = 1; x < columns - 1; ++x) {
+    Put(x, 0, kHorizontal, border);
+    Put(x, rows - 1, kHorizontal, border);
+  }
+  for (int y = 1; y < rows - 1; ++y) {
+    Put(0, y, kVertical, border);
+    Put(columns - 1, y, kVertical, border);
+  }
+
+  for (const auto& note : NotesInRows(snapshot.notes, -1, snapshot.height)) {
+    const int y = static_cast<int>(InterpolatedNoteY(snapshot, note));
+    if (y < 0 || y >= snapshot.height) {
+      continue;
+    }
+    const ItemInfo& item = Item(note.type);
+    const int x = NoteColumn(snapshot, note);
+    const ftxui::Color color = ItemColor(note.type);
+    Put(x, 1 + y, item.glyph, color);
+    // Wide glyphs own the following cells; FTXUI leaves those empty.
+    for (int i = 1; i < item.width; ++i) {
+      Put(x + i, 1 + y, "", color);
+    }
+  }
+
+  const int catcher_y = 1 + CatcherRow(snapshot.height);
+  const int start_x = 1 + CatcherStartColumn(snapshot.player_x, snapshot.width);
+  const bool catcher_flash = snapshot.catcher_flash_frames > 0;
+  PutAscii(start_x, catcher_y, "|___|",
+           catcher_flash ? ftxui::Color::YellowLight : ftxui::Color::CyanLight);
+  if (sparkles && catcher_flash && catcher_y > 1) {
+    PutAscii(start_x + 1, catcher_y - 1, (snapshot.catcher_flash_frames % 2 == 0) ? " * " : " + ",
+             ftxui::Color::White);
+  }
+
+  changed_cells_ = 0;
+  for (size_t i = 0; i < size; ++i) {
+    if (!resized && next_[i] == cells_[i]) {
+      continue;
+    }
+    cells_[i] = next_[i];
+    pixels_[i].character.assign(next_[i].glyph.data(), next_[i].glyph.size());
+    pixels_[i].foreground_color = next_[i].color;
+    changed_cells_++;
+  }
+}
+
+ftxui::Element CellBoard::Render() const {
+  return std::make_shared<CellBoardNode>(this);
+}
+
+void CellBoard::Put(int x, int y, std::string_view glyph, ftxui::Color color) {
+  if (x < 0 || y < 0 || x >= columns_ || y >= rows_) {
+    return;
+  }
+  next_[static_cast<size_t>(y) * static_cast<size_t>(columns_) + static_cast<size_t>(x)] =
+      Cell{glyph, color};
+}
+
+void CellBoard::PutAscii(int x, int y, std::string_view text, ftxui::Color color) {
+  static constexpr char kAscii[] =
+      " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+  for (size_t i = 0; i < text.size(); ++i) {
+    const unsigned char c = static_cast<unsigned char>(text[i]);
+    if (c < 0x20 || c > 0x7E) {
+      continue;
+    }
+    // Point into static storage so the cell outlives the caller's string.
+    Put(x + static_cast<int>(i), y, std::string_view(&kAscii[c - 0x20], 1), color);
+  }
+}
+
+}  // namespace vday
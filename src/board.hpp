@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <ftxui/dom/elements.hpp>
+#include <ftxui/screen/screen.hpp>
+
+#include "game.hpp"
+
+namespace vday {
+
+// Draws the bordered board through ftxui::Canvas at 2x4 braille resolution.
+// `sparkles` controls the effect above a flashing catcher.
+ftxui::Element RenderGameCanvas(const GameSnapshot& snapshot, bool sparkles = true);
+
+// Writes "Score: N  Streak: N  Misses: N" into `out`, reusing its buffer.
+void FormatScoreLine(const GameSnapshot& snapshot, std::string& out);
+// Appends `label` followed by `value` to `out` without temporaries.
+void AppendStat(std::string& out, std::string_view label, long value);
+
+// Alternative board backend: keeps a flat (width + 2) x (height + 2) cell
+// buffer for the bordered board and blits it straight into the FTXUI Screen,
+// skipping Canvas and its per-cell strings. Only cells that differ from the
+// previous Update() have their pixel re-encoded; the blit itself copies every
+// cell, since FTXUI clears its Screen after each flush.
+class CellBoard {
+ public:
+  void Update(const GameSnapshot& snapshot, bool sparkles = true);
+  ftxui::Element Render() const;
+
+  int columns() const { return columns_; }
+  int rows() const { return rows_; }
+  int changed_cells() const { return changed_cells_; }
+  const ftxui::Pixel& PixelAt(int x, int y) const { return pixels_[y * columns_ + x]; }
+
+ private:
+  struct Cell {
+    std::string_view glyph = " ";
+    ftxui::Color color;
+    bool operator==(const Cell& other) const {
+      return glyph == other.glyph && color == other.color;
+    }
+  };
+
+  void Put(int x, int y, std::string_view glyph, ftxui::Color color);
+  // ASCII only: one byte per cell.
+  void PutAscii(int x, int y, std::string_view text, ftxui::Color color);
+
+  int columns_ = 0;
+  int rows_ = 0;
+  int changed_cells_ = 0;
+  std::vector<Cell> cells_;
+  std::vector<Cell> next_;
+  std::vector<ftxui::Pixel> pixels_;
+};
+
+}  // namespace vday
@@ -0,0 +1,167 @@
+#include "checkpoint.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "game.hpp"
+
+namespace vday {
+
+namespace {
+
+// The RNG is stored as its state words and position, written explicitly, so a
+// record does not depend on any standard library's object layout and a bad
+// position is rejected rather than handed to the generator.
+using RngWords = std::array<std::uint32_t, Mt19937::kStateWords>;
+constexpr size_t kRngBytes = sizeof(std::uint32_t) + sizeof(RngWords);
+
+constexpr std::uint32_t kMagic = 0x4b434456;  // "VDCK"
+constexpr std::uint16_t kVersion = 3;
+
+struct Header {
+  std::uint32_t magic;
+  std::uint16_t version;
+  std::uint16_t rng_words;
+  std::uint32_t note_count;
+};
+
+struct Scalars {
+  std::int32_t width;
+  std::int32_t height;
+  std::int32_t player_x;
+  std::int32_t score;
+  std::int32_t streak;
+  std::int32_t misses;
+  std::int32_t unlocked_chunks;
+  std::int32_t catcher_flash_frames;
+  std::int32_t paused;
+  std::int32_t spawn_ticks;
+};
+
+struct PackedNote {
+  std::int32_t x;
+  std::int32_t y;
+  std::int32_t type;
+};
+
+template <typename T>
+void Append(std::vector<std::uint8_t>& out, size_t& offset, const T& value) {
+  std::memcpy(out.data() + offset, &value, sizeof(T));
+  offset += sizeof(T);
+}
+
+}  // namespace
+
+void EncodeState(const GameSnapshot& snapshot, int spawn_ticks, const Mt19937& rng,
+                 std::vector<std::uint8_t>& out, size_t first_note, std::int32_t fall) {
+  const size_t note_count = snapshot.notes.size() - first_note;
+  out.resize(sizeof(Header) + sizeof(Scalars) + kRngBytes + note_count * sizeof(PackedNote));
+  size_t offset = 0;
+  Append(out, offset,
+         Header{kMagic, kVersion, static_cast<std::uint16_t>(Mt19937::kStateWords),
+                static_cast<std::uint32_t>(note_count)});
+  Append(out, offset,
+         Scalars{snapshot.width, snapshot.height, snapshot.player_x, snapshot.score,
+                 snapshot.streak, snapshot.misses, snapshot.unlocked_chunks,
+                 snapshot.catcher_flash_frames, snapshot.paused ? 1 : 0, spawn_ticks});
+  Append(out, offset, rng.index());
+  Append(out, offset, rng.state());
+  for (size_t i = first_note; i < snapshot.notes.size(); ++i) {
+    const Note& note = snapshot.notes[i];
+    Append(out, offset, PackedNote{note.x, note.y + fall, static_cast<std::int32_t>(note.type)});
+  }
+}
+
+bool DecodeState(const std::uint8_t* data, size_t size, GameSnapshot& snapshot,
+                 int& spawn_ticks, Mt19937& rng) {
+  Header header;
+  if (size < sizeof(Header)) {
+    return false;
+  }
+  std::memcpy(&header, data, sizeof(Header));
+  const size_t expected = sizeof(Header) + sizeof(Scalars) + kRngBytes +
+                          static_cast<size_t>(header.note_count) * sizeof(PackedNote);
+  if (header.magic != kMagic || header.version != kVersion ||
+      header.rng_words != Mt19937::kStateWords || size != expected) {
+    return false;
+  }
+
+  Scalars scalars;
+  size_t offset = sizeof(Header);
+  std::memcpy(&scalars, data + offset, sizeof(Scalars));
+  offset += sizeof(Scalars);
+  if (scalars.width <= 0 || scalars.height <= 0) {
+    return false;
+  }
+  std::uint32_t rng_index = 0;
+  std::memcpy(&rng_index, data + offset, sizeof(rng_index));
+  if (rng_index > Mt19937::kStateWords) {
+    return false;
+  }
+  // Validate every note before touching the outputs.
+  for (size_t i = 0; i < header.note_count; ++i) {
+    PackedNote note;
+    std::memcpy(&note, data + offset + kRngBytes + i * sizeof(PackedNote), sizeof(PackedNote));
+    if (note.type < 0 || note.type >= static_cast<std::int32_t>(kItems.size())) {
+      return false;
+    }
+  }
+
+  RngWords rng_words;
+  std::memcpy(rng_words.data(), data + offset + sizeof(rng_index), sizeof(RngWords));
+  rng.Restore(rng_words, rng_index);
+  offset += kRngBytes;
+  snapshot.width = scalars.width;
+  snapshot.height = scalars.height;
+  snapshot.player_x = scalars.player_x;
+  snapshot.score = scalars.score;
+  snapshot.streak = scalars.streak;
+  snapshot.misses = scalars.misses;
+  snapshot.unlocked_chunks = scalars.unlocked_chunks;
+  snapshot.catcher_flash_frames = scalars.catcher_flash_frames;
+  snapshot.paused = scalars.paused != 0;
+  spawn_ticks = scalars.spawn_ticks;
+  snapshot.notes.resize(header.note_count);
+  for (auto& note : snapshot.notes) {
+    PackedNote packed;
+    std::memcpy(&packed, data + offset, sizeof(PackedNote));
+    offset += sizeof(PackedNote);
+    note = Note{packed.x, packed.y, static_cast<ItemType>(packed.type)};
+  }
+  return true;
+}
+
+CheckpointRing::CheckpointRing(size_t slots) : slots_(std::max<size_t>(1, slots)) {
+  // Room for the RNG and a screenful of notes, so steady-state checkpoints
+  // never allocate.
+  for (auto& slot : slots_) {
+    slot.reserve(kRngBytes + 1024);
+  }
+}
+
+std::vector<std::uint8_t>& CheckpointRing::Next() {
+  return slots_[head_];
+}
+
+void CheckpointRing::Commit() {
+  head_ = (head_ + 1) % slots_.size();
+  count_ = std::min(count_ + 1, slots_.size());
+}
+
+const std::vector<std::uint8_t>& CheckpointRing::Back(size_t age) const {
+  return slots_[(head_ + slots_.size() - 1 - age % slots_.size()) % slots_.size()];
+}
+
+void CheckpointRing::DropNewest(size_t count) {
+  count = std::min(count, count_);
+  head_ = (head_ + slots_.size() - count) % slots_.size();
+  count_ -= count;
+}
+
+void CheckpointRing::Clear() {
+  head_ = 0;
+  count_ = 0;
+}
+
+}  // namespace vday
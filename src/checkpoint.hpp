@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "rng.hpp"
+
+namespace vday {
+
+struct GameSnapshot;
+
+// A checkpoint holds everything needed to continue a run exactly: the game
+// fields of the snapshot, the ticks since the last spawn and the RNG. It is a
+// flat binary record of a few KB, mostly the RNG's 624 state words, so taking
+// one is a handful of memcpys.
+
+// Replaces the contents of `out`; its capacity is reused. Notes before
+// `first_note` are left out and the rest are stored `fall` lower, which lets
+// the engine checkpoint without settling its lazily-fallen notes.
+void EncodeState(const GameSnapshot& snapshot, int spawn_ticks, const Mt19937& rng,
+                 std::vector<std::uint8_t>& out, size_t first_note = 0, std::int32_t fall = 0);
+// Fills the game fields of `snapshot` (not the timing fields), `spawn_ticks`
+// and `rng`. Returns false, leaving them untouched, if `data` is not a record
+// written by this build.
+bool DecodeState(const std::uint8_t* data, size_t size, GameSnapshot& snapshot,
+                 int& spawn_ticks, Mt19937& rng);
+
+// Fixed number of preallocated checkpoint slots; the newest overwrites the
+// oldest. Not thread-safe: GameEngine uses it under its snapshot mutex.
+class CheckpointRing {
+ public:
+  explicit CheckpointRing(size_t slots);
+
+  // Buffer for the next checkpoint; fill it, then call Commit().
+  std::vector<std::uint8_t>& Next();
+  void Commit();
+
+  size_t size() const { return count_; }
+  // 0 is the newest checkpoint.
+  const std::vector<std::uint8_t>& Back(size_t age) const;
+  // Forgets the `count` newest checkpoints, e.g. after rewinding past them.
+  void DropNewest(size_t count);
+  void Clear();
+
+ private:
+  std::vector<std::vector<std::uint8_t>> slots_;
+  size_t head_ = 0;  // slot Next() hands out
+  size_t count_ = 0;
+};
+
+}  // namespace vday
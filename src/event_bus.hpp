@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace vday {
+
+// Publish/subscribe over one fixed ring of events. Publish writes each event
+// once, whatever the number of subscribers, and never allocates or waits for
+// them. Every subscriber has its own read cursor into the ring. One that falls
+// more than `capacity` events behind skips ahead, and Dropped() counts what it
+// missed.
+template <typename Event>
+class EventBus {
+ public:
+  using Subscription = size_t;
+
+  explicit EventBus(size_t capacity = 1024) : ring_(capacity) {}
+
+  // `wake` runs on the publishing thread after every Publish, once the event
+  // is in the ring and the bus is unlocked. It must be cheap and must not
+  // subscribe or unsubscribe; it may Poll.
+  Subscription Subscribe(std::function<void()> wake = {}) {
+    std::scoped_lock lock(mutex_, wake_mutex_);
+    subscribers_.push_back(Subscriber{next_, 0});
+    wakes_.push_back(std::move(wake));
+    return subscribers_.size() - 1;
+  }
+
+  // No wake for this subscription runs after Unsubscribe returns.
+  void Unsubscribe(Subscription subscription) {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    wakes_[subscription] = nullptr;
+  }
+
+  void Publish(const Event& event) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ring_[next_ % ring_.size()] = event;
+      next_++;
+    }
+    // Only the wake list is held here, so a woken subscriber can poll while
+    // the others are still being woken.
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    for (const auto& wake : wakes_) {
+      if (wake) {
+        wake();
+      }
+    }
+  }
+
+  // Calls `visit` with each event this subscriber has not seen yet, in order,
+  // straight from the ring, and returns how many there were. `visit` runs with
+  // the bus locked, so it should only record what it needs and act after
+  // Poll returns.
+  template <typename Visit>
+  size_t Poll(Subscription subscription, Visit&& visit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& subscriber = subscribers_[subscription];
+    if (next_ - subscriber.cursor > ring_.size()) {
+      subscriber.dropped += next_ - ring_.size() - subscriber.cursor;
+      subscriber.cursor = next_ - ring_.size();
+    }
+    const size_t count = static_cast<size_t>(next_ - subscriber.cursor);
+    for (; subscriber.cursor < next_; ++subscriber.cursor) {
+      const Event& event = ring_[subscriber.cursor % ring_.size()];
+      visit(event);
+    }
+    return count;
+  }
+
+  std::uint64_t Dropped(Subscription subscription) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return subscribers_[subscription].dropped;
+  }
+
+ private:
+  struct Subscriber {
+    std::uint64_t cursor = 0;
+    std::uint64_t dropped = 0;
+  };
+
+  // mutex_ guards the ring and the cursors, wake_mutex_ the wake callbacks,
+  // indexed by subscription like subscribers_.
+  mutable std::mutex mutex_;
+  std::vector<Event> ring_;
+  std::uint64_t next_ = 0;
+  std::vector<Subscriber> subscribers_;
+  std::mutex wake_mutex_;
+  std::vector<std::function<void()>> wakes_;
+};
+
+}  // namespace vday
@@ -3,12 +3,16 @@
 #include <algorithm>
 #include <chrono>
 
+#include "shm_ring.hpp"
+
 namespace vday {
 
 namespace {
 
 constexpr int kCatcherWidth = 5;
 constexpr int kCatcherWallMargin = 0;
+// Traces pile up only while nobody collects them; drop the oldest past this.
+constexpr size_t kMaxPendingInputTraces = 1024;
 
 int MinCatcherStart(int width) {
   (void)width;
@@ -23,6 +27,12 @@ int MaxCatcherStart(int width) {
   return max_start;
 }
 
+}  // namespace
+
+int CatcherStartColumn(int player_x, int width) {
+  return std::clamp(player_x - 2, MinCatcherStart(width), MaxCatcherStart(width));
+}
+
 int MinPlayerX(int width) {
   return MinCatcherStart(width) + 2;
 }
@@ -31,29 +41,72 @@ int MaxPlayerX(int width) {
   return MaxCatcherStart(width) + 2;
 }
 
-}  // namespace
+bool CatcherCatches(int player_x, int width, const Note& note) {
+  const int catcher_start = CatcherStartColumn(player_x, width);
+  const int catcher_inner_left = catcher_start + 1;
+  const int catcher_inner_right = catcher_start + 3;
 
-int CatcherStartColumn(int player_x, int width) {
-  return std::clamp(player_x - 2, MinCatcherStart(width), MaxCatcherStart(width));
+  const int note_left = note.x;
+  const int note_right = note.x + ItemVisualWidth(note.type) - 1;
+  return note_left <= catcher_inner_right && note_right >= catcher_inner_left;
 }
 
 int CatcherRow(int height) {
   return height - 1;
 }
 
-int ItemVisualWidth(ItemType type) {
-  (void)type;
-  // All current note symbols are emoji and render as two terminal cells.
-  return 2;
+int CatcherXAtCrossing(int start_x, std::span<const CatcherMove> moves, int height,
+                       const Note& note, std::int32_t fall) {
+  const std::int64_t row_top = std::int64_t{CatcherRow(height)} << kNoteRowShift;
+  const std::int64_t before = std::int64_t{note.y} - fall;
+  // A note already in the row as the tick began meets the catcher at 0.
+  std::int64_t crossing = 0;
+  if (before < row_top && fall > 0) {
+    crossing = std::min<std::int64_t>((row_top - before) * kSubTickUnits / fall, kSubTickUnits);
+  }
+  int x = start_x;
+  for (const CatcherMove& move : moves) {
+    if (move.at > crossing) {
+      break;
+    }
+    x = move.x;
+  }
+  return x;
+}
+
+void SortNotesByRow(std::vector<Note>& notes) {
+  std::stable_sort(notes.begin(), notes.end(),
+                   [](const Note& a, const Note& b) { return a.y > b.y; });
+}
+
+std::span<const Note> NotesInRows(const std::vector<Note>& notes, int first_row, int end_row) {
+  const auto begin = std::partition_point(notes.begin(), notes.end(),
+                                          [&](const Note& note) { return NoteRow(note) >= end_row; });
+  const auto end = std::partition_point(begin, notes.end(),
+                                        [&](const Note& note) { return NoteRow(note) >= first_row; });
+  return {begin, end};
+}
+
+int MovePlayer(int player_x, int width, InputAction action) {
+  const int step = 2;
+  if (action == InputAction::MoveLeft) {
+    return std::max(MinPlayerX(width), player_x - step);
+  }
+  if (action == InputAction::MoveRight) {
+    return std::min(MaxPlayerX(width), player_x + step);
+  }
+  return player_x;
 }
 
 GameEngine::GameEngine() {
   std::random_device rd;
-  rng_ = std::mt19937(rd());
+  rng_.seed(rd());
   snapshot_.width = 40;
   snapshot_.height = 20;
   snapshot_.player_x =
       std::clamp(snapshot_.width / 2, MinPlayerX(snapshot_.width), MaxPlayerX(snapshot_.width));
+  tick_start_player_x_ = snapshot_.player_x;
+  ArmTimers(0, 0);
 }
 
 GameEngine::~GameEngine() {
@@ -68,19 +121,75 @@ void GameEngine::Start() {
   thread_ = std::thread(&GameEngine::RunLoop, this);
 }
 
+void GameEngine::SetTickRate(int ticks_per_second) {
+  std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  // Timers are in ticks, so they are re-armed for the new rate.
+  const int spawn_ticks = SpawnTicks();
+  SettleSnapshot();
+  tick_rate_ = std::clamp(ticks_per_second, 1, 1000);
+  snapshot_.tick_rate = tick_rate_;
+  ArmTimers(spawn_ticks, snapshot_.catcher_flash_frames);
+}
+
+void GameEngine::SetThreadTuning(const ThreadTuning& tuning) {
+  thread_tuning_ = tuning;
+}
+
+void GameEngine::SetSnapshotRing(ShmSnapshotWriter* ring) {
+  snapshot_ring_ = ring;
+}
+
+const std::string& GameEngine::ThreadSummary() const {
+  return thread_summary_;
+}
+
+const JitterStats& GameEngine::TickJitter() const {
+  return tick_jitter_;
+}
+
 void GameEngine::Stop() {
   if (!running_) {
     return;
   }
-  running_ = false;
+  {
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    running_ = false;
+  }
+  park_cv_.notify_all();
   if (thread_.joinable()) {
     thread_.join();
   }
 }
 
+void GameEngine::Suspend() {
+  std::lock_guard<std::mutex> lock(park_mutex_);
+  suspended_ = true;
+}
+
+void GameEngine::Resume() {
+  {
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    suspended_ = false;
+  }
+  park_cv_.notify_all();
+}
+
+bool GameEngine::Suspended() const {
+  std::lock_guard<std::mutex> lock(park_mutex_);
+  return suspended_;
+}
+
+size_t GameEngine::DroppedInputs() const {
+  return input_queue_.Dropped();
+}
+
 void GameEngine::Reset() {
   std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  checkpoints_.Clear();
+  ticks_since_checkpoint_ = 0;
   snapshot_.notes.clear();
+  pending_fall_ = 0;
+  resolved_notes_ = 0;
   snapshot_.score = 0;
   snapshot_.streak = 0;
   snapshot_.misses = 0;
@@ -89,69 +198,223 @@ void GameEngine::Reset() {
   snapshot_.catcher_flash_frames = 0;
   snapshot_.player_x =
       std::clamp(snapshot_.width / 2, MinPlayerX(snapshot_.width), MaxPlayerX(snapshot_.width));
-  spawn_timer_ = 0.0f;
+  tick_start_player_x_ = snapshot_.player_x;
+  catcher_moves_.clear();
+  ArmTimers(0, 0);
   input_queue_.Clear();
-  event_queue_.Clear();
 }
 
-void GameEngine::PushInput(InputAction action) {
-  input_queue_.Push(action);
+void GameEngine::Seed(std::uint32_t seed) {
+  rng_.seed(seed);
 }
 
-bool GameEngine::TryPopEvent(GameEvent& out) {
-  return event_queue_.TryPop(out);
+void GameEngine::Restore(const GameSnapshot& snapshot) {
+  std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  snapshot_ = snapshot;
+  snapshot_.tick_rate = tick_rate_;
+  snapshot_.tick = tick_;
+  SortNotesByRow(snapshot_.notes);
+  pending_fall_ = 0;
+  resolved_notes_ = 0;
+  tick_start_player_x_ = snapshot_.player_x;
+  catcher_moves_.clear();
+  ArmTimers(0, snapshot_.catcher_flash_frames);
+  checkpoints_.Clear();
+  ticks_since_checkpoint_ = 0;
 }
 
-bool GameEngine::TryPopAudio(AudioCommand& out) {
-  return audio_queue_.TryPop(out);
+void GameEngine::SetCheckpointInterval(int ticks) {
+  std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  checkpoint_interval_ = std::max(0, ticks);
+}
+
+void GameEngine::SaveState(std::vector<std::uint8_t>& out) {
+  std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  SettleSnapshot();
+  EncodeState(snapshot_, SpawnTicks(), rng_, out);
+}
+
+bool GameEngine::LoadState(const std::vector<std::uint8_t>& data) {
+  std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  GameSnapshot loaded = snapshot_;
+  int spawn_ticks = 0;
+  Mt19937 rng;
+  if (!DecodeState(data.data(), data.size(), loaded, spawn_ticks, rng) ||
+      loaded.width != snapshot_.width || loaded.height != snapshot_.height) {
+    return false;
+  }
+  snapshot_ = std::move(loaded);
+  SortNotesByRow(snapshot_.notes);
+  pending_fall_ = 0;
+  resolved_notes_ = 0;
+  tick_start_player_x_ = snapshot_.player_x;
+  catcher_moves_.clear();
+  ArmTimers(spawn_ticks, snapshot_.catcher_flash_frames);
+  rng_ = rng;
+  checkpoints_.Clear();
+  ticks_since_checkpoint_ = 0;
+  return true;
+}
+
+void GameEngine::RunTicks(int ticks) {
+  for (int i = 0; i < ticks; ++i) {
+    ApplyQueuedInputs({}, {});
+    StepSimulation();
+  }
+  if (snapshot_ring_ != nullptr) {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    UpdateTimingFields();
+    snapshot_ring_->Publish(snapshot_, resolved_notes_, pending_fall_);
+  }
+}
+
+std::uint64_t GameEngine::PushInput(InputAction action) {
+  const std::uint64_t id = next_input_id_.fetch_add(1, std::memory_order_relaxed);
+  input_queue_.Push(InputEvent{action, id, std::chrono::steady_clock::now()});
+  {
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    inputs_waiting_ = true;
+  }
+  park_cv_.notify_one();
+  return id;
+}
+
+EngineBus& GameEngine::Events() {
+  return bus_;
 }
 
 GameSnapshot GameEngine::Snapshot() {
   std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  SettleSnapshot();
   return snapshot_;
 }
 
+void GameEngine::SnapshotInto(GameSnapshot& out) {
+  std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  SettleSnapshot();
+  out = snapshot_;
+}
+
+void GameEngine::SetInputTracing(bool enabled) {
+  trace_inputs_ = enabled;
+}
+
+void GameEngine::TakeInputTraces(std::vector<InputTrace>& out) {
+  std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  out.insert(out.end(), input_traces_.begin(), input_traces_.end());
+  input_traces_.clear();
+}
+
 void GameEngine::RunLoop() {
   using clock = std::chrono::steady_clock;
+  thread_summary_ = ApplyThreadTuning("game", thread_tuning_);
+  tick_jitter_.Clear();
   auto last = clock::now();
-  const float dt = 1.0f / 60.0f;
+  const float dt = 1.0f / static_cast<float>(tick_rate_);
+  const auto tick_length = std::chrono::duration_cast<clock::duration>(std::chrono::duration<float>(dt));
   float accumulator = 0.0f;
 
   while (running_) {
+    {
+      std::unique_lock<std::mutex> lock(park_mutex_);
+      if (suspended_) {
+        park_cv_.wait(lock, [&] { return !suspended_ || !running_; });
+        // Hidden time is not simulated and does not count as tick lateness.
+        last = clock::now();
+        accumulator = 0.0f;
+        continue;
+      }
+    }
+
     auto now = clock::now();
     std::chrono::duration<float> delta = now - last;
     last = now;
     accumulator += delta.count();
 
-    InputAction action;
-    while (input_queue_.TryPop(action)) {
-      HandleInput(action);
-    }
-
+    // The next tick to simulate began `accumulator` seconds ago. When several
+    // are due, each one sees only the inputs pushed while it ran.
+    auto tick_start =
+        now - std::chrono::duration_cast<clock::duration>(std::chrono::duration<float>(accumulator));
+    bool changed = false;
     while (accumulator >= dt) {
-      StepSimulation(dt);
+      ApplyQueuedInputs(tick_start, tick_length);
+      // Each due tick was scheduled `accumulator - dt` seconds ago.
+      tick_jitter_.Add(std::chrono::duration_cast<clock::duration>(
+          std::chrono::duration<float>(accumulator - dt)));
+      StepSimulation();
       accumulator -= dt;
+      tick_start += tick_length;
+      changed = true;
+    }
+    // The rest were pushed during the tick in progress.
+    changed |= ApplyQueuedInputs(tick_start, tick_length);
+
+    const auto next_tick =
+        now + std::chrono::duration_cast<clock::duration>(std::chrono::duration<float>(dt - accumulator));
+    bool paused = false;
+    {
+      std::lock_guard<std::mutex> lock(snapshot_mutex_);
+      next_tick_due_ = next_tick;
+      paused = snapshot_.paused;
+      if (snapshot_ring_ != nullptr && changed) {
+        UpdateTimingFields();
+        snapshot_ring_->Publish(snapshot_, resolved_notes_, pending_fall_);
+      }
     }
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    // Sleep until the next tick is due or an input arrives. A paused game has
+    // no tick due at all, and the time it spends paused is not simulated.
+    std::unique_lock<std::mutex> lock(park_mutex_);
+    const auto woken = [&] { return inputs_waiting_ || suspended_ || !running_; };
+    if (paused) {
+      park_cv_.wait(lock, woken);
+      last = clock::now();
+      accumulator = 0.0f;
+    } else {
+      park_cv_.wait_until(lock, next_tick, woken);
+    }
+    inputs_waiting_ = false;
   }
 
-  audio_queue_.Push(AudioCommand{AudioCommandType::Stop, false});
+  std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  next_tick_due_ = {};
 }
 
-void GameEngine::HandleInput(InputAction action) {
+bool GameEngine::ApplyQueuedInputs(std::chrono::steady_clock::time_point tick_start,
+                                   std::chrono::steady_clock::duration tick_length) {
+  input_queue_.DrainInto(pending_inputs_);
+  std::int32_t at = 0;
+  size_t applied = 0;
+  for (; applied < pending_inputs_.size(); ++applied) {
+    const InputEvent& input = pending_inputs_[applied];
+    if (tick_length.count() > 0) {
+      if (input.pushed >= tick_start + tick_length) {
+        break;  // belongs to a later tick
+      }
+      // Clamped, and never earlier than the move before it.
+      const auto into = std::clamp(input.pushed - tick_start, decltype(tick_length){0}, tick_length);
+      at = std::max(at, static_cast<std::int32_t>(into * kSubTickUnits / tick_length));
+    }
+    HandleInput(input, at);
+  }
+  pending_inputs_.erase(pending_inputs_.begin(),
+                        pending_inputs_.begin() + static_cast<std::ptrdiff_t>(applied));
+  return applied > 0;
+}
+
+void GameEngine::HandleInput(const InputEvent& input, std::int32_t at) {
+  const auto dequeued = std::chrono::steady_clock::now();
   std::lock_guard<std::mutex> lock(snapshot_mutex_);
-  const int step = 2;
-  const int min_player_x = MinPlayerX(snapshot_.width);
-  const int max_player_x = MaxPlayerX(snapshot_.width);
-  if (action == InputAction::MoveLeft) {
-    snapshot_.player_x = std::max(min_player_x, snapshot_.player_x - step);
-  } else if (action == InputAction::MoveRight) {
-    snapshot_.player_x = std::min(max_player_x, snapshot_.player_x + step);
+  const InputAction action = input.action;
+  if (action == InputAction::MoveLeft || action == InputAction::MoveRight) {
+    snapshot_.player_x = MovePlayer(snapshot_.player_x, snapshot_.width, action);
+    catcher_moves_.push_back(CatcherMove{at, snapshot_.player_x});
   } else if (action == InputAction::TogglePause) {
     snapshot_.paused = !snapshot_.paused;
   } else if (action == InputAction::Reset) {
     snapshot_.notes.clear();
+    pending_fall_ = 0;
+    resolved_notes_ = 0;
     snapshot_.score = 0;
     snapshot_.streak = 0;
     snapshot_.misses = 0;
@@ -160,102 +423,215 @@ void GameEngine::HandleInput(InputAction action) {
     snapshot_.catcher_flash_frames = 0;
     snapshot_.player_x =
         std::clamp(snapshot_.width / 2, MinPlayerX(snapshot_.width), MaxPlayerX(snapshot_.width));
-    spawn_timer_ = 0.0f;
+    tick_start_player_x_ = snapshot_.player_x;
+    catcher_moves_.clear();
+    ArmTimers(0, 0);
+    checkpoints_.Clear();
+    ticks_since_checkpoint_ = 0;
+  } else if (action == InputAction::Rewind) {
+    RewindLocked();
+  }
+
+  snapshot_.last_input_id = input.id;
+  if (trace_inputs_) {
+    if (input_traces_.size() >= kMaxPendingInputTraces) {
+      input_traces_.erase(input_traces_.begin());
+    }
+    InputTrace trace;
+    trace.id = input.id;
+    trace.pushed = input.pushed;
+    trace.dequeued = dequeued;
+    trace.applied = std::chrono::steady_clock::now();
+    input_traces_.push_back(trace);
   }
 }
 
-void GameEngine::StepSimulation(float dt) {
+void GameEngine::StepSimulation() {
   std::lock_guard<std::mutex> lock(snapshot_mutex_);
   if (snapshot_.paused) {
+    // Moves made while paused do not count as a sweep.
+    tick_start_player_x_ = snapshot_.player_x;
+    catcher_moves_.clear();
     return;
   }
-  if (snapshot_.catcher_flash_frames > 0) {
-    snapshot_.catcher_flash_frames -= 1;
-  }
+  // Runs the spawn and flash timers due this tick.
+  tick_timers_.Advance(++tick_);
+  snapshot_.tick = tick_;
 
-  spawn_timer_ += dt;
-  if (spawn_timer_ >= 0.6f) {
-    spawn_timer_ = 0.0f;
-    SpawnNote();
-  }
-
-  for (auto& note : snapshot_.notes) {
-    note.y += dt * 10.0f;
-  }
+  const std::int32_t fall = NoteFallPerTick(tick_rate_);
+  pending_fall_ += fall;
 
+  // Only the lowest notes can have reached the catcher row; the first one
+  // still above it ends the scan.
+  auto& notes = snapshot_.notes;
   int caught = 0;
   int missed = 0;
-  for (auto& note : snapshot_.notes) {
-    int result = CatchOrMiss(note);
+  while (resolved_notes_ < notes.size()) {
+    Note note = notes[resolved_notes_];
+    note.y += pending_fall_;
+    const int result = CatchOrMiss(note, fall);
+    if (result < 0) {
+      break;
+    }
     if (result > 0) {
       caught++;
-    } else if (result == 0) {
+    } else {
       missed++;
     }
+    resolved_notes_++;
   }
 
-  snapshot_.notes.erase(
-      std::remove_if(snapshot_.notes.begin(), snapshot_.notes.end(), [&](const Note& n) {
-        return static_cast<int>(n.y) >= CatcherRow(snapshot_.height);
-      }),
-      snapshot_.notes.end());
+  // Dropping resolved notes moves the live ones, so it waits until they are
+  // outnumbered; that keeps it O(1) per note. Pending fall is folded in before
+  // stored rows could overflow.
+  if (resolved_notes_ == notes.size()) {
+    notes.clear();
+    resolved_notes_ = 0;
+    pending_fall_ = 0;
+  } else if (resolved_notes_ * 2 >= notes.size() || pending_fall_ >= kMaxPendingFall) {
+    SettleSnapshot();
+  }
 
   if (missed > 0) {
     snapshot_.misses += missed;
     snapshot_.streak = 0;
-    audio_queue_.Push(AudioCommand{AudioCommandType::PlayMiss, false});
+    bus_.Publish(NotesMissed{missed, snapshot_.misses});
   }
 
   if (caught > 0) {
-    snapshot_.catcher_flash_frames = 10;
-    audio_queue_.Push(AudioCommand{AudioCommandType::PlayCatch, false});
+    StartFlash(TicksFor(kCatcherFlashMs, tick_rate_));
+    bus_.Publish(NotesCaught{caught, snapshot_.score, snapshot_.streak});
   }
 
   int new_unlocked = snapshot_.score / unlock_score_step_;
   if (new_unlocked > snapshot_.unlocked_chunks) {
     snapshot_.unlocked_chunks = new_unlocked;
-    event_queue_.Push(GameEvent{GameEventType::UnlockChunk, new_unlocked});
-    audio_queue_.Push(AudioCommand{AudioCommandType::PlayUnlock, false});
+    bus_.Publish(ChunkUnlocked{new_unlocked});
   }
+
+  tick_start_player_x_ = snapshot_.player_x;
+  catcher_moves_.clear();
+  TakeCheckpoint();
 }
 
-void GameEngine::SpawnNote() {
-  std::uniform_int_distribution<int> type_dist(0, 99);
-
-  int roll = type_dist(rng_);
-  ItemType type = ItemType::Heart;
-  if (roll < 45) {
-    type = ItemType::Heart;
-  } else if (roll < 70) {
-    type = ItemType::LoveNote;
-  } else if (roll < 90) {
-    type = ItemType::Kiss;
-  } else {
-    type = ItemType::BrokenHeart;
+void GameEngine::TakeCheckpoint() {
+  if (checkpoint_interval_ <= 0 || ++ticks_since_checkpoint_ < checkpoint_interval_) {
+    return;
+  }
+  ticks_since_checkpoint_ = 0;
+  UpdateTimingFields();
+  EncodeState(snapshot_, SpawnTicks(), rng_, checkpoints_.Next(), resolved_notes_, pending_fall_);
+  checkpoints_.Commit();
+}
+
+void GameEngine::RewindLocked() {
+  if (checkpoints_.size() == 0) {
+    return;
+  }
+  const int ticks_back = kRewindSeconds * tick_rate_;
+  const size_t wanted = static_cast<size_t>(std::max(0, ticks_back / std::max(1, checkpoint_interval_)));
+  const size_t age = std::min(wanted, checkpoints_.size() - 1);
+  const auto& record = checkpoints_.Back(age);
+  const bool paused = snapshot_.paused;
+  SettleSnapshot();
+  int spawn_ticks = 0;
+  if (!DecodeState(record.data(), record.size(), snapshot_, spawn_ticks, rng_)) {
+    return;
   }
+  ArmTimers(spawn_ticks, snapshot_.catcher_flash_frames);
+  snapshot_.paused = paused;
+  tick_start_player_x_ = snapshot_.player_x;
+  catcher_moves_.clear();
+  // The restored checkpoint stays as the newest; everything after it is gone.
+  checkpoints_.DropNewest(age);
+  ticks_since_checkpoint_ = 0;
+}
+
+void GameEngine::SpawnNote() {
+  std::uniform_int_distribution<int> type_dist(0, kSpawnWeightTotal - 1);
+  const ItemType type = ItemForRoll(type_dist(rng_));
 
   const int max_x = std::max(0, snapshot_.width - ItemVisualWidth(type));
   std::uniform_int_distribution<int> x_dist(0, max_x);
-  snapshot_.notes.push_back(Note{x_dist(rng_), 0.0f, type});
+  // Stored against the fall still pending for the notes already on the board.
+  snapshot_.notes.push_back(Note{x_dist(rng_), -pending_fall_, type});
+}
+
+void GameEngine::SettleSnapshot() {
+  auto& notes = snapshot_.notes;
+  notes.erase(notes.begin(), notes.begin() + static_cast<std::ptrdiff_t>(resolved_notes_));
+  resolved_notes_ = 0;
+  if (pending_fall_ != 0) {
+    for (auto& note : notes) {
+      note.y += pending_fall_;
+    }
+    pending_fall_ = 0;
+  }
+  UpdateTimingFields();
+}
+
+void GameEngine::UpdateTimingFields() {
+  if (const auto deadline = tick_timers_.Deadline(flash_timer_)) {
+    snapshot_.catcher_flash_frames = static_cast<int>(*deadline - tick_);
+  }
+  if (next_tick_due_ != std::chrono::steady_clock::time_point{}) {
+    // How far the clock is through the tick in progress.
+    const std::chrono::duration<float> until = next_tick_due_ - std::chrono::steady_clock::now();
+    snapshot_.interpolation_alpha =
+        snapshot_.paused ? 0.0f
+                         : std::clamp(1.0f - until.count() * static_cast<float>(tick_rate_), 0.0f, 1.0f);
+  }
 }
 
-int GameEngine::CatchOrMiss(Note& note) {
+void GameEngine::ArmTimers(int spawn_ticks, int flash_frames) {
+  tick_timers_.Cancel(spawn_timer_);
+  const int interval = TicksFor(kSpawnIntervalMs, tick_rate_);
+  spawn_timer_ = tick_timers_.Schedule(tick_ + static_cast<std::uint64_t>(std::max(1, interval - spawn_ticks)),
+                                       [this] { OnSpawnTimer(); });
+  if (flash_frames > 0) {
+    StartFlash(flash_frames);
+  } else {
+    tick_timers_.Cancel(flash_timer_);
+    flash_timer_ = 0;
+    snapshot_.catcher_flash_frames = 0;
+  }
+}
+
+int GameEngine::SpawnTicks() const {
+  const auto deadline = tick_timers_.Deadline(spawn_timer_);
+  if (!deadline) {
+    return 0;
+  }
+  return TicksFor(kSpawnIntervalMs, tick_rate_) - static_cast<int>(*deadline - tick_);
+}
+
+void GameEngine::OnSpawnTimer() {
+  SpawnNote();
+  spawn_timer_ = tick_timers_.Schedule(
+      tick_ + static_cast<std::uint64_t>(TicksFor(kSpawnIntervalMs, tick_rate_)), [this] { OnSpawnTimer(); });
+}
+
+void GameEngine::StartFlash(int frames) {
+  tick_timers_.Cancel(flash_timer_);
+  snapshot_.catcher_flash_frames = frames;
+  flash_timer_ = tick_timers_.Schedule(tick_ + static_cast<std::uint64_t>(frames), [this] {
+    snapshot_.catcher_flash_frames = 0;
+    flash_timer_ = 0;
+  });
+}
+
+int GameEngine::CatchOrMiss(const Note& note, std::int32_t fall) {
   const int catcher_row = CatcherRow(snapshot_.height);
-  const int note_row = static_cast<int>(note.y);
+  const int note_row = NoteRow(note);
   if (note_row < catcher_row) {
     return -1;
   }
 
-  const int catcher_start = CatcherStartColumn(snapshot_.player_x, snapshot_.width);
-  const int catcher_inner_left = catcher_start + 1;
-  const int catcher_inner_right = catcher_start + 3;
-
-  const int note_left = note.x;
-  const int note_right = note.x + ItemVisualWidth(note.type) - 1;
-  const bool overlaps_catcher =
-      note_left <= catcher_inner_right && note_right >= catcher_inner_left;
-
-  if (overlaps_catcher) {
+  // Judged where the catcher was as the note entered its row, however far
+  // past the row a fast note has fallen by now.
+  const int catcher_x =
+      CatcherXAtCrossing(tick_start_player_x_, catcher_moves_, snapshot_.height, note, fall);
+  if (CatcherCatches(catcher_x, snapshot_.width, note)) {
     int delta = ScoreFor(note.type);
     snapshot_.score += delta;
     if (note.type == ItemType::BrokenHeart) {
@@ -269,17 +645,7 @@ int GameEngine::CatchOrMiss(Note& note) {
 }
 
 int GameEngine::ScoreFor(ItemType type) const {
-  switch (type) {
-    case ItemType::Heart:
-      return 10;
-    case ItemType::LoveNote:
-      return 20;
-    case ItemType::Kiss:
-      return 30;
-    case ItemType::BrokenHeart:
-      return -15;
-  }
-  return 0;
+  return ItemScore(type);
 }
 
 }  // namespace vday
@@ -1,36 +1,92 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <mutex>
 #include <random>
+#include <span>
+#include <string>
 #include <thread>
+#include <variant>
 #include <vector>
 
+#include "checkpoint.hpp"
+#include "event_bus.hpp"
+#include "items.hpp"
+#include "latency.hpp"
+#include "rng.hpp"
 #include "thread_queue.hpp"
+#include "thread_tuning.hpp"
+#include "timer_wheel.hpp"
 
 namespace vday {
 
+class ShmSnapshotWriter;
+
 enum class InputAction {
   MoveLeft,
   MoveRight,
   TogglePause,
   ReturnToDashboard,
   Reset,
+  Rewind,  // back about kRewindSeconds, to the nearest checkpoint
 };
 
-enum class ItemType {
-  Heart,
-  LoveNote,
-  Kiss,
-  BrokenHeart,
+struct InputEvent {
+  InputAction action = InputAction::MoveLeft;
+  std::uint64_t id = 0;
+  std::chrono::steady_clock::time_point pushed;
 };
 
+// The simulation is integer-only, so a seed replays bit for bit whatever the
+// compiler flags. Note rows are fixed point with kNoteRowUnits per row, which
+// leaves room for boards up to 32767 rows. Timings are whole ticks.
+inline constexpr int kNoteRowShift = 16;
+inline constexpr std::int32_t kNoteRowUnits = std::int32_t{1} << kNoteRowShift;
+// Notes fall at a fixed rate in rows per second regardless of the tick rate.
+inline constexpr int kNoteFallRowsPerSecond = 10;
+inline constexpr int kSpawnIntervalMs = 600;
+inline constexpr int kCatcherFlashMs = 167;
+inline constexpr int kDefaultTickRate = 60;
+inline constexpr int kRewindSeconds = 3;
+
+// Fixed-point rows a note falls per tick. The division truncates, so notes
+// run under 0.01% slow at 60 ticks per second.
+constexpr std::int32_t NoteFallPerTick(int tick_rate) {
+  return kNoteFallRowsPerSecond * kNoteRowUnits / tick_rate;
+}
+
+// `ms` milliseconds in ticks, rounded, and at least one.
+constexpr int TicksFor(int ms, int tick_rate) {
+  return std::max(1, (ms * tick_rate + 500) / 1000);
+}
+
 struct Note {
   int x = 0;
-  float y = 0.0f;
+  std::int32_t y = 0;  // fixed point, kNoteRowUnits per row
   ItemType type = ItemType::Heart;
 };
 
+// The board row a note is on, and its position in rows for drawing.
+constexpr int NoteRow(const Note& note) {
+  return note.y >> kNoteRowShift;
+}
+
+constexpr float NoteRows(const Note& note) {
+  return static_cast<float>(note.y) / static_cast<float>(kNoteRowUnits);
+}
+
+// GameSnapshot::notes runs from the lowest note to the highest. Notes spawn
+// at the top and all fall at the same rate, so the engine keeps that order
+// without work, and every board row is one contiguous run of notes.
+// Snapshots built elsewhere go through SortNotesByRow first.
+void SortNotesByRow(std::vector<Note>& notes);
+// The notes on rows first_row .. end_row - 1, found by binary search.
+std::span<const Note> NotesInRows(const std::vector<Note>& notes, int first_row, int end_row);
+
 struct GameSnapshot {
   int width = 40;
   int height = 20;
@@ -41,34 +97,79 @@ struct GameSnapshot {
   int misses = 0;
   int unlocked_chunks = 0;
   int catcher_flash_frames = 0;
-  std::vector<Note> notes;
+  std::uint64_t last_input_id = 0;
+  // Ticks simulated by the engine so far; changes exactly once per tick.
+  std::uint64_t tick = 0;
+  // Simulation ticks per second, and how far (0..1) the game thread had
+  // progressed towards the next tick when this snapshot was published.
+  int tick_rate = kDefaultTickRate;
+  float interpolation_alpha = 0.0f;
+  std::vector<Note> notes;  // ordered, see SortNotesByRow
 };
 
-enum class GameEventType {
-  UnlockChunk,
+// Engine events, published at most once each per tick on GameEngine::Events().
+struct NotesCaught {
+  int count = 0;
+  int score = 0;
+  int streak = 0;
 };
 
-struct GameEvent {
-  GameEventType type = GameEventType::UnlockChunk;
-  int value = 0;
+struct NotesMissed {
+  int count = 0;
+  int misses = 0;
+};
+
+struct ChunkUnlocked {
+  int unlocked_chunks = 0;
 };
 
+using EngineEvent = std::variant<NotesCaught, NotesMissed, ChunkUnlocked>;
+using EngineBus = EventBus<EngineEvent>;
+
 enum class AudioCommandType {
   PlayCatch,
   PlayMiss,
   PlayUnlock,
   SetEnabled,
+  ReloadSounds,
   Stop,
 };
 
 struct AudioCommand {
   AudioCommandType type = AudioCommandType::PlayCatch;
   bool enabled = true;
+  // Stamped by AudioEngine::PushCommand to measure how long the audio thread
+  // takes to wake up.
+  std::chrono::steady_clock::time_point queued{};
 };
 
 int CatcherStartColumn(int player_x, int width);
 int CatcherRow(int height);
-int ItemVisualWidth(ItemType type);
+int MinPlayerX(int width);
+int MaxPlayerX(int width);
+// True when a note resolving at the catcher row lands inside the catcher.
+bool CatcherCatches(int player_x, int width, const Note& note);
+
+// Times within a tick, in 1/kSubTickUnits of the tick.
+inline constexpr std::int32_t kSubTickUnits = std::int32_t{1} << 16;
+
+// A catcher move made during a tick: the input arrived `at` into the tick and
+// left the catcher centred on `x`.
+struct CatcherMove {
+  std::int32_t at = 0;
+  int x = 0;
+};
+
+// Swept collision: where the catcher stood at the moment `note`, which fell
+// `fall` during the tick, crossed into the catcher row. The catcher starts the
+// tick at start_x and makes `moves` in order. Judging at that moment rather
+// than at the end of the tick keeps catches independent of the tick rate, and
+// of how far past the row a fast note has fallen.
+int CatcherXAtCrossing(int start_x, std::span<const CatcherMove> moves, int height,
+                       const Note& note, std::int32_t fall);
+// Where the catcher centre ends up after a MoveLeft/MoveRight; other actions
+// leave it in place.
+int MovePlayer(int player_x, int width, InputAction action);
 
 class GameEngine {
  public:
@@ -78,33 +179,142 @@ class GameEngine {
   void Start();
   void Stop();
 
-  void PushInput(InputAction action);
-  bool TryPopEvent(GameEvent& out);
-  bool TryPopAudio(AudioCommand& out);
+  // Parks the engine thread on a condition variable (no wakeups at all) until
+  // Resume(). Time spent parked is not simulated. May be called before Start().
+  void Suspend();
+  void Resume();
+  bool Suspended() const;
+
+  // Takes effect on the next Start().
+  void SetTickRate(int ticks_per_second);
+  void SetThreadTuning(const ThreadTuning& tuning);
+  // Also publish every simulated frame into `ring` (not owned); null turns
+  // it off. Set it before Start().
+  void SetSnapshotRing(ShmSnapshotWriter* ring);
+
+  // What the last Start() managed to apply, and how late each tick ran
+  // against the fixed-step schedule. Read after Stop().
+  const std::string& ThreadSummary() const;
+  const JitterStats& TickJitter() const;
+
+  // Inputs discarded because the bounded input queue was full.
+  size_t DroppedInputs() const;
+
+  std::uint64_t PushInput(InputAction action);
+  EngineBus& Events();
   GameSnapshot Snapshot();
+  // Copies into `out`, reusing its note storage, so a caller that keeps one
+  // snapshot around copies without allocating.
+  void SnapshotInto(GameSnapshot& out);
+
+  // When enabled, every applied input leaves an InputTrace behind that the
+  // renderer collects with TakeInputTraces().
+  void SetInputTracing(bool enabled);
+  void TakeInputTraces(std::vector<InputTrace>& out);
 
   void Reset();
 
+  // Headless use: when the engine thread is not running, callers can seed the
+  // RNG, load a state and advance the simulation synchronously. RunTicks
+  // applies queued inputs before each tick, just like RunLoop; read events
+  // through a subscription on Events() as usual.
+  void Seed(std::uint32_t seed);
+  void Restore(const GameSnapshot& snapshot);
+  void RunTicks(int ticks);
+
+  // The engine records a checkpoint every `ticks` simulated ticks into a ring
+  // of kCheckpointSlots, which is what Rewind steps back through. 0 disables.
+  void SetCheckpointInterval(int ticks);
+  // Encode the current run, or continue one, for saving across launches. A
+  // record from another build or board size is rejected.
+  void SaveState(std::vector<std::uint8_t>& out);
+  bool LoadState(const std::vector<std::uint8_t>& data);
+
  private:
   void RunLoop();
-  void StepSimulation(float dt);
-  void HandleInput(InputAction action);
+  void StepSimulation();
+  // `tick_start` is when the tick that will see these inputs began, used to
+  // place each move within it. Inputs pushed after that tick ended wait in
+  // pending_inputs_ for a later call. Headless callers pass a zero
+  // `tick_length`, which applies every input at the start of the tick.
+  // Returns whether any input was applied.
+  bool ApplyQueuedInputs(std::chrono::steady_clock::time_point tick_start,
+                         std::chrono::steady_clock::duration tick_length);
+  void TakeCheckpoint();
+  void SettleSnapshot();
+  // The O(1) part of SettleSnapshot(): catcher_flash_frames and
+  // interpolation_alpha, for readers that skip resolved notes and apply the
+  // pending fall themselves.
+  void UpdateTimingFields();
+  void ArmTimers(int spawn_ticks, int flash_frames);
+  int SpawnTicks() const;
+  void OnSpawnTimer();
+  void StartFlash(int frames);
+  void RewindLocked();
+  void HandleInput(const InputEvent& input, std::int32_t at);
   void SpawnNote();
-  int CatchOrMiss(Note& note);
+  int CatchOrMiss(const Note& note, std::int32_t fall);
   int ScoreFor(ItemType type) const;
 
+  static constexpr size_t kMaxQueuedInputs = 256;
+
   std::atomic<bool> running_{false};
   std::thread thread_;
+  mutable std::mutex park_mutex_;
+  std::condition_variable park_cv_;
+  bool suspended_ = false;
+  int tick_rate_ = kDefaultTickRate;
+  ThreadTuning thread_tuning_;
+  std::string thread_summary_;
+  JitterStats tick_jitter_;
 
-  ThreadSafeQueue<InputAction> input_queue_;
-  ThreadSafeQueue<GameEvent> event_queue_;
-  ThreadSafeQueue<AudioCommand> audio_queue_;
+  // Bounded so a stalled engine cannot grow memory; the oldest input goes.
+  ThreadSafeQueue<InputEvent> input_queue_{kMaxQueuedInputs, OverflowPolicy::DropOldest};
+  EngineBus bus_;
+  // Drained from input_queue_ but belonging to a tick not yet simulated.
+  std::vector<InputEvent> pending_inputs_;
 
   std::mutex snapshot_mutex_;
   GameSnapshot snapshot_;
+  ShmSnapshotWriter* snapshot_ring_ = nullptr;
+
+  std::atomic<std::uint64_t> next_input_id_{1};
+  std::atomic<bool> trace_inputs_{false};
+  std::vector<InputTrace> input_traces_;
+
+  static constexpr size_t kCheckpointSlots = 64;
+  CheckpointRing checkpoints_{kCheckpointSlots};
+  int checkpoint_interval_ = 15;
+  int ticks_since_checkpoint_ = 0;
+
+  // Set by RunLoop each iteration so snapshots can work out
+  // interpolation_alpha when they are taken; unset when no thread runs.
+  std::chrono::steady_clock::time_point next_tick_due_{};
+  bool inputs_waiting_ = false;  // guarded by park_mutex_
+
+  // Falling is applied lazily, so a tick only touches the notes that reach
+  // the catcher row. Notes before resolved_notes_ are gone, and the rest sit
+  // pending_fall_ lower than stored. SettleSnapshot() folds both back in, and
+  // fills in the timer-driven fields, before snapshot_ is read or written as
+  // a whole. Checkpoints and the shm ring apply both while copying instead,
+  // so the ticks that take them stay lazy.
+  static constexpr std::int32_t kMaxPendingFall = kNoteRowUnits << 10;
+  std::int32_t pending_fall_ = 0;
+  size_t resolved_notes_ = 0;
+
+  // Catcher centre at the end of the previous tick, and its moves since.
+  int tick_start_player_x_ = 0;
+  std::vector<CatcherMove> catcher_moves_;
+
+  // The spawn cadence and the catcher flash run on tick timers. tick_ counts
+  // simulated ticks and never goes back; restoring a state re-arms the
+  // timers from it.
+  TimerWheel tick_timers_;
+  std::uint64_t tick_ = 0;
+  TimerWheel::Id spawn_timer_ = 0;
+  TimerWheel::Id flash_timer_ = 0;
 
-  std::mt19937 rng_;
-  float spawn_timer_ = 0.0f;
+  Mt19937 rng_;
   int unlock_score_step_ = 100;
 };
 
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace vday {
+
+enum class ItemType {
+  Heart,
+  LoveNote,
+  Kiss,
+  BrokenHeart,
+};
+
+struct ItemInfo {
+  int spawn_weight;  // relative odds; see kSpawnWeightTotal
+  int score;
+  int width;  // terminal cells the glyph occupies
+  std::string_view glyph;
+};
+
+// Everything the simulation, scoring and autopilot know about an item, indexed
+// by ItemType. A new item is one enumerator, one row here and one color in the
+// renderer's table (board.cpp).
+inline constexpr std::array kItems = {
+    ItemInfo{45, 10, 2, "\xF0\x9F\x92\x96"},   // Heart 💖
+    ItemInfo{25, 20, 2, "\xF0\x9F\x92\x8C"},   // LoveNote 💌
+    ItemInfo{20, 30, 2, "\xF0\x9F\x92\x8B"},   // Kiss 💋
+    ItemInfo{10, -15, 2, "\xF0\x9F\x92\x94"},  // BrokenHeart 💔
+};
+
+inline constexpr size_t kItemTypeCount = static_cast<size_t>(ItemType::BrokenHeart) + 1;
+static_assert(kItems.size() == kItemTypeCount, "one kItems row per ItemType");
+
+inline constexpr int kSpawnWeightTotal = [] {
+  int total = 0;
+  for (const auto& item : kItems) {
+    total += item.spawn_weight;
+  }
+  return total;
+}();
+
+constexpr const ItemInfo& Item(ItemType type) {
+  return kItems[static_cast<size_t>(type)];
+}
+
+constexpr int ItemScore(ItemType type) {
+  return Item(type).score;
+}
+
+constexpr int ItemVisualWidth(ItemType type) {
+  return Item(type).width;
+}
+
+// Maps a roll in [0, kSpawnWeightTotal) to an item by cumulative weight. The
+// fixed-length sum of comparisons compiles to straight-line code.
+constexpr ItemType ItemForRoll(int roll) {
+  size_t index = 0;
+  int threshold = 0;
+  for (size_t i = 0; i + 1 < kItems.size(); ++i) {
+    threshold += kItems[i].spawn_weight;
+    index += static_cast<size_t>(roll >= threshold);
+  }
+  return static_cast<ItemType>(index);
+}
+
+static_assert(ItemForRoll(44) == ItemType::Heart && ItemForRoll(45) == ItemType::LoveNote &&
+              ItemForRoll(70) == ItemType::Kiss && ItemForRoll(kSpawnWeightTotal - 1) == ItemType::BrokenHeart);
+
+}  // namespace vday
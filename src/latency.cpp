@@ -0,0 +1,84 @@
+#include "latency.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace vday {
+
+namespace {
+
+const char* StageName(int stage) {
+  switch (stage) {
+    case LatencyRecorder::kQueue:
+      return "queue";
+    case LatencyRecorder::kApply:
+      return "apply";
+    case LatencyRecorder::kPublish:
+      return "publish";
+    case LatencyRecorder::kFlush:
+      return "flush";
+    case LatencyRecorder::kTotal:
+      return "total";
+  }
+  return "?";
+}
+
+double PercentileMicros(std::vector<std::int64_t>& sorted, double p) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+  index = std::min(index, sorted.size() - 1);
+  return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+}  // namespace
+
+LatencyRecorder::LatencyRecorder() {
+  for (auto& stage : stages_) {
+    stage.values.reserve(kMaxSamples);
+  }
+}
+
+void LatencyRecorder::Record(const InputTrace& trace) {
+  Add(kQueue, trace.dequeued - trace.pushed);
+  Add(kApply, trace.applied - trace.dequeued);
+  Add(kPublish, trace.picked_up - trace.applied);
+  Add(kFlush, trace.flushed - trace.picked_up);
+  Add(kTotal, trace.flushed - trace.pushed);
+  count_++;
+}
+
+size_t LatencyRecorder::Count() const {
+  return count_;
+}
+
+std::string LatencyRecorder::Report() const {
+  std::string out = "input-to-frame latency (" + std::to_string(count_) + " inputs, microseconds)\n";
+  char line[128];
+  std::snprintf(line, sizeof(line), "  %-8s %10s %10s %10s\n", "stage", "p50", "p99", "p999");
+  out += line;
+  for (int stage = 0; stage < kStageCount; ++stage) {
+    std::vector<std::int64_t> sorted = stages_[stage].values;
+    std::sort(sorted.begin(), sorted.end());
+    std::snprintf(line, sizeof(line), "  %-8s %10.1f %10.1f %10.1f\n", StageName(stage),
+                  PercentileMicros(sorted, 0.50), PercentileMicros(sorted, 0.99),
+                  PercentileMicros(sorted, 0.999));
+    out += line;
+  }
+  return out;
+}
+
+void LatencyRecorder::Add(Stage stage, std::chrono::steady_clock::duration value) {
+  auto& samples = stages_[stage];
+  const std::int64_t ns =
+      std::max<std::int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(value).count());
+  if (samples.values.size() < kMaxSamples) {
+    samples.values.push_back(ns);
+  } else {
+    samples.values[samples.next] = ns;
+    samples.next = (samples.next + 1) % kMaxSamples;
+  }
+}
+
+}  // namespace vday
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vday {
+
+// Timestamps collected for a single input as it travels from the FTXUI event
+// handler through the game thread and into a flushed frame.
+struct InputTrace {
+  std::uint64_t id = 0;
+  std::chrono::steady_clock::time_point pushed;
+  std::chrono::steady_clock::time_point dequeued;
+  std::chrono::steady_clock::time_point applied;
+  std::chrono::steady_clock::time_point picked_up;
+  std::chrono::steady_clock::time_point flushed;
+};
+
+class LatencyRecorder {
+ public:
+  enum Stage {
+    // pushed -> dequeued: the engine thread waking on park_cv_ and draining
+    // the input, plus, while catching up, the due ticks that came before it
+    kQueue,
+    kApply,    // dequeued -> applied under snapshot_mutex_
+    kPublish,  // applied -> snapshot copied by the renderer
+    kFlush,    // snapshot copied -> frame written to the terminal
+    kTotal,    // pushed -> flushed
+    kStageCount,
+  };
+
+  LatencyRecorder();
+
+  void Record(const InputTrace& trace);
+  size_t Count() const;
+  std::string Report() const;
+
+ private:
+  static constexpr size_t kMaxSamples = 1 << 16;
+
+  struct Samples {
+    std::vector<std::int64_t> values;
+    size_t next = 0;
+  };
+
+  void Add(Stage stage, std::chrono::steady_clock::duration value);
+
+  std::array<Samples, kStageCount> stages_;
+  size_t count_ = 0;
+};
+
+}  // namespace vday
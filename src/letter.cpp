@@ -0,0 +1,111 @@
+#include "letter.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace vday {
+
+std::vector<std::string> SplitParagraphs(const std::string& text) {
+  std::vector<std::string> chunks;
+  std::string current;
+  std::istringstream input(text);
+  std::string line;
+  bool last_blank = false;
+
+  while (std::getline(input, line)) {
+    if (line.empty()) {
+      if (!current.empty()) {
+        chunks.push_back(current);
+        current.clear();
+      }
+      last_blank = true;
+      continue;
+    }
+    if (last_blank && !current.empty()) {
+      chunks.push_back(current);
+      current.clear();
+    }
+    if (!current.empty()) {
+      current += "\n";
+    }
+    current += line;
+    last_blank = false;
+  }
+  if (!current.empty()) {
+    chunks.push_back(current);
+  }
+  return chunks;
+}
+
+void WrapParagraph(std::string_view text, int width, std::vector<std::string>& lines) {
+  lines.clear();
+  width = std::max(1, width);
+  auto is_space = [](char c) { return c == ' ' || c == '\n' || c == '\t' || c == '\r'; };
+  // UTF-8 continuation bytes do not start a column.
+  auto columns = [](std::string_view s) {
+    return static_cast<int>(std::count_if(s.begin(), s.end(), [](char c) {
+      return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+    }));
+  };
+
+  std::string line;
+  int line_columns = 0;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    while (pos < text.size() && is_space(text[pos])) {
+      pos++;
+    }
+    const size_t end = std::find_if(text.begin() + static_cast<std::ptrdiff_t>(pos), text.end(),
+                                    is_space) - text.begin();
+    std::string_view word = text.substr(pos, end - pos);
+    pos = end;
+    while (!word.empty()) {
+      const int word_columns = columns(word);
+      const int needed = line_columns == 0 ? word_columns : line_columns + 1 + word_columns;
+      if (needed <= width) {
+        if (line_columns != 0) {
+          line += ' ';
+        }
+        line += word;
+        line_columns = needed;
+        break;
+      }
+      if (line_columns != 0) {
+        lines.push_back(std::move(line));
+        line.clear();
+        line_columns = 0;
+        continue;
+      }
+      // Longer than a whole line: take `width` code points of it.
+      size_t cut = 0;
+      for (int taken = 0; cut < word.size(); ++cut) {
+        if ((static_cast<unsigned char>(word[cut]) & 0xC0) != 0x80 && taken++ == width) {
+          break;
+        }
+      }
+      lines.emplace_back(word.substr(0, cut));
+      word.remove_prefix(cut);
+    }
+  }
+  if (line_columns != 0) {
+    lines.push_back(std::move(line));
+  }
+}
+
+std::filesystem::path LetterPath() {
+  return std::filesystem::current_path() / "assets" / "letter.txt";
+}
+
+bool ReadLetterFile(const std::filesystem::path& path, std::string& out) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  out = buffer.str();
+  return true;
+}
+
+}  // namespace vday
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vday {
+
+// Splits letter text into paragraphs separated by one or more blank lines.
+std::vector<std::string> SplitParagraphs(const std::string& text);
+
+// Greedy word wrap to `width` columns, one column per code point, matching
+// how ftxui::paragraph flows words. Runs of whitespace (newlines included)
+// separate words; a word longer than a line is split. Replaces `lines`.
+void WrapParagraph(std::string_view text, int width, std::vector<std::string>& lines);
+
+std::filesystem::path LetterPath();
+bool ReadLetterFile(const std::filesystem::path& path, std::string& out);
+
+}  // namespace vday
@@ -1,7 +1,12 @@
 #include "app.hpp"
+#include "spectator.hpp"
 
-int main() {
-  vday::App app;
+int main(int argc, char** argv) {
+  const vday::AppOptions options = vday::ParseOptions(argc, argv);
+  if (!options.spectate.empty()) {
+    return vday::RunSpectator(options.spectate);
+  }
+  vday::App app(options);
   app.Run();
   return 0;
 }
@@ -0,0 +1,101 @@
+#include "options.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "shm_ring.hpp"
+#include "spectator.hpp"
+
+namespace vday {
+
+namespace {
+
+bool ParseValue(const std::string& arg, const std::string& name, int& out) {
+  const std::string prefix = name + "=";
+  if (arg.compare(0, prefix.size(), prefix) != 0) {
+    return false;
+  }
+  try {
+    out = std::stoi(arg.substr(prefix.size()));
+  } catch (...) {
+    std::cerr << "Invalid value for " << name << ": " << arg.substr(prefix.size()) << "\n";
+  }
+  return true;
+}
+
+// Accepts `name` alone, meaning `fallback`, or `name=VALUE`.
+bool ParsePath(const std::string& arg, const std::string& name, const std::string& fallback,
+               std::string& out) {
+  if (arg == name) {
+    out = fallback;
+    return true;
+  }
+  const std::string prefix = name + "=";
+  if (arg.compare(0, prefix.size(), prefix) != 0) {
+    return false;
+  }
+  out = arg.substr(prefix.size());
+  return true;
+}
+
+}  // namespace
+
+AppOptions ParseOptions(int argc, char** argv) {
+  AppOptions options;
+  options.remote = std::getenv("SSH_CONNECTION") != nullptr;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--latency-report") {
+      options.latency_report = true;
+    } else if (arg == "--startup-trace") {
+      options.startup_trace = true;
+    } else if (ParseValue(arg, "--tick-rate", options.tick_rate)) {
+      continue;
+    } else if (arg == "--board=canvas") {
+      options.board = BoardBackend::Canvas;
+    } else if (arg == "--board=cells") {
+      options.board = BoardBackend::Cells;
+    } else if (arg == "--autopilot") {
+      options.autopilot = true;
+    } else if (arg == "--hide-letter-panel") {
+      options.show_letter_panel = false;
+    } else if (arg == "--remote") {
+      options.remote = true;
+    } else if (arg == "--no-remote") {
+      options.remote = false;
+    } else if (ParseValue(arg, "--remote-budget", options.remote_budget)) {
+      continue;
+    } else if (ParseValue(arg, "--game-cpu", options.game_cpu)) {
+      continue;
+    } else if (ParseValue(arg, "--audio-cpu", options.audio_cpu)) {
+      continue;
+    } else if (ParseValue(arg, "--rt-priority", options.rt_priority)) {
+      continue;
+    } else if (ParseValue(arg, "--nice", options.nice)) {
+      continue;
+    } else if (arg == "--thread-report") {
+      options.thread_report = true;
+    } else if (ParseValue(arg, "--frame-budget-ms", options.frame_budget_ms)) {
+      continue;
+    } else if (ParseValue(arg, "--checkpoint-ticks", options.checkpoint_ticks)) {
+      continue;
+    } else if (ParsePath(arg, "--spectator-server", DefaultSpectatorSocket(),
+                         options.spectator_server)) {
+      continue;
+    } else if (ParseValue(arg, "--spectator-fps", options.spectator_fps)) {
+      continue;
+    } else if (ParsePath(arg, "--shm-ring", kDefaultShmName, options.shm_ring)) {
+      continue;
+    } else if (ParseValue(arg, "--shm-notes", options.shm_notes)) {
+      continue;
+    } else if (ParsePath(arg, "--spectate", DefaultSpectatorSocket(), options.spectate)) {
+      continue;
+    } else {
+      std::cerr << "Unknown option: " << arg << "\n";
+    }
+  }
+  return options;
+}
+
+}  // namespace vday
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+
+namespace vday {
+
+enum class BoardBackend {
+  Canvas,
+  Cells,
+};
+
+struct AppOptions {
+  bool latency_report = false;
+  bool startup_trace = false;
+  int tick_rate = 60;
+  BoardBackend board = BoardBackend::Cells;
+  bool show_letter_panel = true;
+  bool autopilot = false;
+  // Remote mode paces redraws to a terminal output budget. It defaults to on
+  // when SSH_CONNECTION is set.
+  bool remote = false;
+  int remote_budget = 16384;
+  // Scheduling for the game and audio threads; see ThreadTuning.
+  int game_cpu = -1;
+  int audio_cpu = -1;
+  int rt_priority = 0;
+  int nice = 0;
+  bool thread_report = false;
+  // Render+flush time per frame the quality governor aims for; 0 disables it.
+  int frame_budget_ms = 8;
+  // Ticks between rewind checkpoints; 0 disables rewind.
+  int checkpoint_ticks = 15;
+  // Unix socket the game streams snapshots to spectators on; empty disables it.
+  std::string spectator_server;
+  int spectator_fps = 30;
+  // POSIX shared-memory name the engine publishes every frame under; empty
+  // disables it. At most shm_notes notes per frame are published.
+  std::string shm_ring;
+  int shm_notes = 1024;
+  // When set, valentine_tui only watches the game streaming on this socket.
+  std::string spectate;
+};
+
+AppOptions ParseOptions(int argc, char** argv);
+
+}  // namespace vday
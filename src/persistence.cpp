@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 
 namespace vday {
@@ -83,6 +84,34 @@ std::filesystem::path Persistence::SavePath() const {
   return PreferredSavePath();
 }
 
+std::filesystem::path Persistence::RunPath() const {
+  return SavePath().parent_path() / "run.bin";
+}
+
+bool Persistence::LoadRun(std::vector<std::uint8_t>& out) {
+  std::ifstream file(RunPath(), std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+  out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return !out.empty();
+}
+
+void Persistence::SaveRun(const std::vector<std::uint8_t>& data) {
+  std::filesystem::path path = RunPath();
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    return;
+  }
+  file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+}
+
+void Persistence::ClearRun() {
+  std::error_code ec;
+  std::filesystem::remove(RunPath(), ec);
+}
+
 int Persistence::ParseInt(const std::string& content, const std::string& key, int fallback) {
   std::string pattern = "\"" + key + "\"";
   auto pos = content.find(pattern);
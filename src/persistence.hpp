@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <string>
 #include <vector>
@@ -23,8 +24,15 @@ class Persistence {
   ProgressData Load();
   void Save(const ProgressData& data);
 
+  // A run in progress, as an opaque GameEngine::SaveState record kept next
+  // to the progress file.
+  bool LoadRun(std::vector<std::uint8_t>& out);
+  void SaveRun(const std::vector<std::uint8_t>& data);
+  void ClearRun();
+
  private:
   std::filesystem::path SavePath() const;
+  std::filesystem::path RunPath() const;
   static int ParseInt(const std::string& content, const std::string& key, int fallback);
   static bool ParseBool(const std::string& content, const std::string& key, bool fallback);
 };
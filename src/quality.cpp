@@ -0,0 +1,46 @@
+#include "quality.hpp"
+
+namespace vday {
+
+const char* QualityName(QualityLevel level) {
+  switch (level) {
+    case QualityLevel::Full:
+      return "full";
+    case QualityLevel::LowFps:
+      return "low fps";
+    case QualityLevel::NoLetterPanel:
+      return "no letter panel";
+    case QualityLevel::FrozenReveal:
+      return "frozen reveal";
+    case QualityLevel::NoSparkles:
+      return "no sparkles";
+  }
+  return "?";
+}
+
+QualityGovernor::QualityGovernor(std::chrono::microseconds budget) : budget_(budget) {}
+
+bool QualityGovernor::OnFrame(std::chrono::steady_clock::duration cost) {
+  if (budget_.count() <= 0) {
+    return false;
+  }
+  const double sample = std::chrono::duration<double, std::micro>(cost).count();
+  average_us_ = average_us_ == 0.0 ? sample : average_us_ + kSmoothing * (sample - average_us_);
+
+  const double budget = static_cast<double>(budget_.count());
+  over_frames_ = average_us_ > budget ? over_frames_ + 1 : 0;
+  under_frames_ = average_us_ < budget * kHeadroom ? under_frames_ + 1 : 0;
+
+  if (over_frames_ >= kStepDownFrames && level_ != QualityLevel::NoSparkles) {
+    level_ = static_cast<QualityLevel>(static_cast<int>(level_) + 1);
+  } else if (under_frames_ >= kStepUpFrames && level_ != QualityLevel::Full) {
+    level_ = static_cast<QualityLevel>(static_cast<int>(level_) - 1);
+  } else {
+    return false;
+  }
+  over_frames_ = 0;
+  under_frames_ = 0;
+  return true;
+}
+
+}  // namespace vday
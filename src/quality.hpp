@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+
+namespace vday {
+
+// Rendering quality, from everything on down. Each level keeps the cuts of
+// the levels above it.
+enum class QualityLevel {
+  Full,
+  LowFps,          // redraw at kLowFps instead of every animation frame
+  NoLetterPanel,   // game screen shows only the board
+  FrozenReveal,    // letter typewriter stops advancing
+  NoSparkles,      // catcher flash without the sparkle above it
+};
+
+const char* QualityName(QualityLevel level);
+
+// Steps rendering quality down while the smoothed render+flush time of a frame
+// stays over budget, and back up once it has stayed well under. Asymmetric
+// hold times keep it from flapping between levels.
+class QualityGovernor {
+ public:
+  static constexpr int kLowFps = 30;
+
+  // A zero budget disables the governor; it then always reports Full.
+  explicit QualityGovernor(std::chrono::microseconds budget);
+
+  // Returns true when the level changed.
+  bool OnFrame(std::chrono::steady_clock::duration cost);
+
+  QualityLevel level() const { return level_; }
+  bool AtLeast(QualityLevel level) const { return level_ >= level; }
+  double average_ms() const { return average_us_ / 1000.0; }
+
+ private:
+  static constexpr double kSmoothing = 0.1;
+  static constexpr double kHeadroom = 0.5;
+  static constexpr int kStepDownFrames = 30;
+  static constexpr int kStepUpFrames = 180;
+
+  std::chrono::microseconds budget_;
+  QualityLevel level_ = QualityLevel::Full;
+  double average_us_ = 0.0;
+  int over_frames_ = 0;
+  int under_frames_ = 0;
+};
+
+}  // namespace vday
@@ -0,0 +1,61 @@
+#include "remote.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace vday {
+
+OutputMeter::~OutputMeter() {
+  Uninstall();
+}
+
+void OutputMeter::Install() {
+  if (target_) {
+    return;
+  }
+  target_ = std::cout.rdbuf(this);
+}
+
+void OutputMeter::Uninstall() {
+  if (!target_) {
+    return;
+  }
+  std::cout.flush();
+  std::cout.rdbuf(target_);
+  target_ = nullptr;
+}
+
+OutputMeter::int_type OutputMeter::overflow(int_type ch) {
+  if (traits_type::eq_int_type(ch, traits_type::eof())) {
+    return traits_type::not_eof(ch);
+  }
+  bytes_.fetch_add(1, std::memory_order_relaxed);
+  return target_->sputc(traits_type::to_char_type(ch));
+}
+
+std::streamsize OutputMeter::xsputn(const char* data, std::streamsize count) {
+  const std::streamsize written = target_->sputn(data, count);
+  bytes_.fetch_add(static_cast<std::uint64_t>(std::max<std::streamsize>(0, written)),
+                   std::memory_order_relaxed);
+  return written;
+}
+
+int OutputMeter::sync() {
+  return target_->pubsync();
+}
+
+FramePacer::FramePacer(int budget_bytes_per_second)
+    : budget_bytes_per_second_(std::max(1, budget_bytes_per_second)) {}
+
+void FramePacer::OnFrame(std::uint64_t bytes) {
+  constexpr double kSmoothing = 0.2;
+  const double sample = static_cast<double>(bytes);
+  bytes_per_frame_ = bytes_per_frame_ == 0.0
+                         ? sample
+                         : bytes_per_frame_ + kSmoothing * (sample - bytes_per_frame_);
+  const auto wanted = std::chrono::microseconds(static_cast<std::int64_t>(
+      bytes_per_frame_ * 1000000.0 / static_cast<double>(budget_bytes_per_second_)));
+  interval_ = std::clamp(wanted, kMinInterval, kMaxInterval);
+}
+
+}  // namespace vday
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <streambuf>
+
+namespace vday {
+
+// Counts every byte written through std::cout (which is where FTXUI sends
+// terminal output) while forwarding it unchanged.
+class OutputMeter : public std::streambuf {
+ public:
+  OutputMeter() = default;
+  ~OutputMeter() override;
+
+  void Install();
+  void Uninstall();
+  std::uint64_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+ protected:
+  int_type overflow(int_type ch) override;
+  std::streamsize xsputn(const char* data, std::streamsize count) override;
+  int sync() override;
+
+ private:
+  std::streambuf* target_ = nullptr;
+  std::atomic<std::uint64_t> bytes_{0};
+};
+
+// Picks a frame interval that keeps terminal output near a byte budget per
+// second, based on a moving average of bytes per frame.
+class FramePacer {
+ public:
+  explicit FramePacer(int budget_bytes_per_second);
+
+  void OnFrame(std::uint64_t bytes);
+  double bytes_per_frame() const { return bytes_per_frame_; }
+  std::chrono::microseconds interval() const { return interval_; }
+
+ private:
+  static constexpr std::chrono::microseconds kMinInterval{1000000 / 30};
+  static constexpr std::chrono::microseconds kMaxInterval{1000000};
+
+  int budget_bytes_per_second_;
+  double bytes_per_frame_ = 0.0;
+  std::chrono::microseconds interval_ = kMinInterval;
+};
+
+}  // namespace vday
@@ -0,0 +1,167 @@
+#include "render_prep.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <utility>
+
+#include <ftxui/dom/node.hpp>
+
+#include "letter.hpp"
+
+namespace vday {
+
+namespace {
+
+constexpr std::string_view kLockedText = "[Locked - play the game to reveal more]";
+
+class WidthProbe : public ftxui::Node {
+ public:
+  WidthProbe(ftxui::Element child, int* width) : Node({std::move(child)}), width_(width) {}
+
+  void ComputeRequirement() override {
+    Node::ComputeRequirement();
+    requirement_ = children_[0]->requirement();
+  }
+
+  void SetBox(ftxui::Box box) override {
+    Node::SetBox(box);
+    *width_ = box.x_max - box.x_min + 1;
+    children_[0]->SetBox(box);
+  }
+
+ private:
+  int* width_;
+};
+
+}  // namespace
+
+ftxui::Element MeasureWidth(ftxui::Element child, int* width) {
+  return std::make_shared<WidthProbe>(std::move(child), width);
+}
+
+ftxui::Element RenderGamePanel(const PreparedFrame& frame, BoardBackend backend,
+                               ftxui::Element stats) {
+  using namespace ftxui;
+  Element board = backend == BoardBackend::Cells ? frame.cells.Render() : frame.canvas;
+  return vbox({
+             text("Falling Love Notes") | bold | center,
+             separator(),
+             board | center,
+             separator(),
+             std::move(stats) | center,
+             text("Arrows/A-D move  P pause  B rewind  R reset  Esc back") | center,
+         }) |
+         border;
+}
+
+ftxui::Element RenderLetterPanel(const PreparedFrame& frame, size_t chunks,
+                                 std::vector<LetterBlock>& blocks,
+                                 const std::function<ftxui::Element(size_t)>& unprepared,
+                                 bool escape_hint, int* width) {
+  using namespace ftxui;
+  blocks.resize(chunks);
+  Elements elements;
+  elements.reserve(chunks);
+  for (size_t i = 0; i < chunks; ++i) {
+    if (i >= frame.letter.size()) {
+      // Nothing prepared yet, e.g. before the panel's width is known.
+      elements.push_back(unprepared(i));
+      continue;
+    }
+    LetterBlock& block = blocks[i];
+    if (block.lines != frame.letter[i]) {
+      Elements lines;
+      lines.reserve(frame.letter[i]->size());
+      for (const auto& line : *frame.letter[i]) {
+        lines.push_back(text(line));
+      }
+      block.element = vbox(std::move(lines));
+      if (frame.letter_locked[i]) {
+        block.element = block.element | dim;
+      }
+      block.lines = frame.letter[i];
+    }
+    elements.push_back(block.element);
+  }
+
+  Elements content = {
+      text("Letter Reveal") | bold | center,
+      separator(),
+      MeasureWidth(vbox(std::move(elements)) | ftxui::frame, width) | flex,
+  };
+  if (escape_hint) {
+    content.push_back(separator());
+    content.push_back(text("Esc to return") | center);
+  }
+  return vbox(std::move(content)) | border;
+}
+
+RenderPrep::RenderPrep(GameEngine& game) : game_(game) {}
+
+void RenderPrep::SetLetter(std::vector<std::string> paragraphs) {
+  letter_ = std::make_shared<const std::vector<std::string>>(std::move(paragraphs));
+}
+
+const PreparedFrame& RenderPrep::Acquire(const PrepSettings& settings) {
+  if (!LetterCurrent(settings)) {
+    PrepareLetter(settings);
+  }
+  PrepareBoard(settings);
+  return frame_;
+}
+
+bool RenderPrep::LetterCurrent(const PrepSettings& settings) const {
+  if (settings.letter_width <= 0) {
+    return frame_.letter_width <= 0;
+  }
+  return frame_.letter_width == settings.letter_width && frame_.letter_text == letter_ &&
+         frame_.letter_shown == settings.letter_shown;
+}
+
+void RenderPrep::PrepareBoard(const PrepSettings& settings) {
+  frame_.board = settings.board;
+  if (!settings.board) {
+    return;
+  }
+  game_.SnapshotInto(frame_.snapshot);
+  if (settings.backend == BoardBackend::Cells) {
+    frame_.cells.Update(frame_.snapshot, settings.sparkles);
+    frame_.canvas = nullptr;
+  } else {
+    frame_.canvas = RenderGameCanvas(frame_.snapshot, settings.sparkles);
+  }
+}
+
+void RenderPrep::PrepareLetter(const PrepSettings& settings) {
+  frame_.letter.clear();
+  frame_.letter_locked.clear();
+  frame_.letter_width = settings.letter_width;
+  frame_.letter_text = letter_;
+  frame_.letter_shown.assign(settings.letter_shown.begin(), settings.letter_shown.end());
+  if (letter_ == nullptr || settings.letter_width <= 0) {
+    return;
+  }
+  if (letter_ != wrapped_letter_) {
+    wrapped_.clear();
+    wrapped_letter_ = letter_;
+  }
+  wrapped_.resize(letter_->size());
+  const size_t count = std::min(letter_->size(), settings.letter_shown.size());
+  for (size_t i = 0; i < count; ++i) {
+    const size_t shown = settings.letter_shown[i];
+    const bool locked = shown == kLockedChunk;
+    WrappedChunk& chunk = wrapped_[i];
+    // Rewrapped only when what it shows or the width changed.
+    if (chunk.lines == nullptr || chunk.shown != shown || chunk.width != settings.letter_width) {
+      auto lines = std::make_shared<std::vector<std::string>>();
+      const std::string_view text = locked ? kLockedText
+                                           : std::string_view((*letter_)[i]).substr(0, shown);
+      WrapParagraph(text, settings.letter_width, *lines);
+      chunk = WrappedChunk{std::move(lines), shown, settings.letter_width};
+    }
+    frame_.letter.push_back(chunk.lines);
+    frame_.letter_locked.push_back(locked);
+  }
+}
+
+}  // namespace vday
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ftxui/dom/elements.hpp>
+
+#include "board.hpp"
+#include "game.hpp"
+#include "options.hpp"
+
+namespace vday {
+
+// What the UI thread wants in the next prepared frame.
+struct PrepSettings {
+  bool board = false;  // copy the snapshot and draw the board
+  BoardBackend backend = BoardBackend::Cells;
+  bool sparkles = true;
+  // Columns to wrap the letter to; 0 leaves the letter out.
+  int letter_width = 0;
+  // Characters shown per letter chunk; kLockedChunk for a locked one.
+  std::vector<size_t> letter_shown;
+};
+
+inline constexpr size_t kLockedChunk = static_cast<size_t>(-1);
+
+// Lays out `child` unchanged and stores the width it was given in `*width`,
+// so the next frame can be prepared for it.
+ftxui::Element MeasureWidth(ftxui::Element child, int* width);
+
+// One frame's board and its wrapped letter lines.
+struct PreparedFrame {
+  bool board = false;  // snapshot, cells and canvas are from the last Acquire()
+  GameSnapshot snapshot;
+  CellBoard cells;                // BoardBackend::Cells
+  ftxui::Element canvas;          // BoardBackend::Canvas
+  // Wrapped lines per letter chunk. Shared with the wrap cache, so an
+  // unchanged chunk costs nothing and its pointer identifies its contents.
+  std::vector<std::shared_ptr<const std::vector<std::string>>> letter;
+  std::vector<bool> letter_locked;
+  int letter_width = 0;
+  // What the lines were wrapped for, to tell whether they are still current.
+  std::shared_ptr<const std::vector<std::string>> letter_text;
+  std::vector<size_t> letter_shown;
+};
+
+// The game screen's board panel: title, board, `stats` and the key help.
+// Shared with the bench's allocation check, so it measures the real frame.
+ftxui::Element RenderGamePanel(const PreparedFrame& frame, BoardBackend backend,
+                               ftxui::Element stats);
+
+// A letter chunk's element, rebuilt only when its wrapped lines change.
+struct LetterBlock {
+  std::shared_ptr<const std::vector<std::string>> lines;
+  ftxui::Element element;
+};
+
+// The letter panel: title, `chunks` letter chunks and, with `escape_hint`,
+// the way back. Chunks with prepared lines are built from them and cached in
+// `blocks`; the rest come from `unprepared`. The width the text is laid out
+// at goes to `*width`. Shared with the bench like RenderGamePanel().
+ftxui::Element RenderLetterPanel(const PreparedFrame& frame, size_t chunks,
+                                 std::vector<LetterBlock>& blocks,
+                                 const std::function<ftxui::Element(size_t)>& unprepared,
+                                 bool escape_hint, int* width);
+
+// Prepares the game frame on the UI thread: copies the snapshot and fills the
+// board at Acquire(), since the board interpolates to the moment it is drawn,
+// and wraps the letter lines, keeping each chunk's lines until what it shows
+// or the width changes.
+class RenderPrep {
+ public:
+  explicit RenderPrep(GameEngine& game);
+
+  // The paragraphs wrapped for the letter panel.
+  void SetLetter(std::vector<std::string> paragraphs);
+  // The next frame, with the board drawn from the game's current state and
+  // the letter wrapped for `settings`. Stays valid until the next Acquire().
+  const PreparedFrame& Acquire(const PrepSettings& settings);
+
+ private:
+  struct WrappedChunk {
+    std::shared_ptr<const std::vector<std::string>> lines;
+    size_t shown = 0;
+    int width = 0;
+  };
+
+  void PrepareBoard(const PrepSettings& settings);
+  void PrepareLetter(const PrepSettings& settings);
+  bool LetterCurrent(const PrepSettings& settings) const;
+
+  GameEngine& game_;
+  PreparedFrame frame_;
+  std::shared_ptr<const std::vector<std::string>> letter_;
+  std::shared_ptr<const std::vector<std::string>> wrapped_letter_;
+  std::vector<WrappedChunk> wrapped_;
+};
+
+}  // namespace vday
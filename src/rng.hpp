@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace vday {
+
+// MT19937 with its state in the open, so checkpoints can store the 624 state
+// words and the position explicitly instead of the bytes of a standard library
+// object. Produces exactly the sequence of std::mt19937 for the same seed, and
+// works with the <random> distributions.
+class Mt19937 {
+ public:
+  using result_type = std::uint_fast32_t;
+  static constexpr size_t kStateWords = 624;
+
+  Mt19937() { seed(5489u); }
+  explicit Mt19937(result_type value) { seed(value); }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<std::uint32_t>::max(); }
+
+  void seed(result_type value) {
+    state_[0] = static_cast<std::uint32_t>(value);
+    for (size_t i = 1; i < kStateWords; ++i) {
+      const std::uint32_t prev = state_[i - 1];
+      state_[i] = 1812433253u * (prev ^ (prev >> 30)) + static_cast<std::uint32_t>(i);
+    }
+    index_ = kStateWords;
+  }
+
+  result_type operator()() {
+    if (index_ >= kStateWords) {
+      Twist();
+    }
+    std::uint32_t y = state_[index_++];
+    y ^= y >> 11;
+    y ^= (y << 7) & 0x9d2c5680u;
+    y ^= (y << 15) & 0xefc60000u;
+    y ^= y >> 18;
+    return y;
+  }
+
+  const std::array<std::uint32_t, kStateWords>& state() const { return state_; }
+  std::uint32_t index() const { return index_; }
+  // Returns false, leaving the engine untouched, for an index past the state.
+  bool Restore(const std::array<std::uint32_t, kStateWords>& state, std::uint32_t index) {
+    if (index > kStateWords) {
+      return false;
+    }
+    state_ = state;
+    index_ = index;
+    return true;
+  }
+
+ private:
+  void Twist() {
+    constexpr size_t kShift = 397;
+    for (size_t i = 0; i < kStateWords; ++i) {
+      const std::uint32_t next = state_[(i + 1) % kStateWords];
+      const std::uint32_t y = (state_[i] & 0x80000000u) | (next & 0x7fffffffu);
+      state_[i] = state_[(i + kShift) % kStateWords] ^ (y >> 1) ^ ((y & 1u) ? 0x9908b0dfu : 0u);
+    }
+    index_ = 0;
+  }
+
+  std::array<std::uint32_t, kStateWords> state_{};
+  std::uint32_t index_ = kStateWords;
+};
+
+}  // namespace vday
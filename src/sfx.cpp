@@ -0,0 +1,134 @@
+#include "sfx.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+
+namespace vday {
+
+namespace {
+
+enum class Waveform {
+  Sine,
+  Triangle,
+};
+
+// One swept, enveloped note. Every sample is a closed-form function of its
+// index (no oscillator state carried between samples), so the render loop
+// has no loop-carried dependency and compilers vectorize it.
+struct Tone {
+  float start_hz;
+  float end_hz;
+  float seconds;
+  float attack_seconds;
+  float gain;
+  Waveform waveform;
+};
+
+constexpr float kPi = 3.14159265358979f;
+
+// Folds a phase x in [-0.5, 0.5] cycles onto the rising quarter wave
+// [-0.25, 0.25] without branches; a triangle wave is just 4x this.
+inline float FoldQuarter(float x) {
+  return std::copysign(0.25f - std::fabs(0.25f - std::fabs(x)), x);
+}
+
+// sin(2*pi*q) for q in [-0.25, 0.25], as an odd Taylor polynomial.
+inline float SinQuarter(float q) {
+  const float t = 2.0f * kPi * q;
+  const float t2 = t * t;
+  return t * (1.0f + t2 * (-1.0f / 6.0f + t2 * (1.0f / 120.0f + t2 * (-1.0f / 5040.0f))));
+}
+
+struct ToneKernel {
+  float inv_rate;
+  float start_hz;
+  float sweep;
+  float inv_length;
+  float sine;
+  float gain;
+};
+
+// Renders samples [begin, end) with the envelope rise = rise_base + rise_slope * t.
+// The body is straight-line arithmetic with no compares, so it vectorizes
+// even without -ffast-math.
+void RenderSpan(const ToneKernel k, int begin, int end, float rise_base, float rise_slope,
+                float* __restrict samples) {
+  for (int i = begin; i < end; ++i) {
+    const float t = static_cast<float>(i) * k.inv_rate;
+    // Phase in cycles of a linear chirp: f0*t + (f1 - f0)*t^2 / (2T).
+    const float phase = t * (k.start_hz + k.sweep * t);
+    const float q = FoldQuarter(phase - static_cast<float>(static_cast<int>(phase + 0.5f)));
+    const float wave = k.sine * SinQuarter(q) + (1.0f - k.sine) * 4.0f * q;
+    const float rise = rise_base + rise_slope * t;
+    const float fall = 1.0f - t * k.inv_length;
+    samples[i] = k.gain * wave * rise * fall * fall * fall;
+  }
+}
+
+void RenderTone(const Tone& tone, int sample_rate, std::vector<float>& out) {
+  const int count = static_cast<int>(tone.seconds * static_cast<float>(sample_rate));
+  const size_t offset = out.size();
+  out.resize(offset + static_cast<size_t>(count));
+
+  ToneKernel kernel;
+  kernel.inv_rate = 1.0f / static_cast<float>(sample_rate);
+  kernel.start_hz = tone.start_hz;
+  kernel.sweep = (tone.end_hz - tone.start_hz) / (2.0f * tone.seconds);
+  kernel.inv_length = 1.0f / tone.seconds;
+  kernel.sine = tone.waveform == Waveform::Sine ? 1.0f : 0.0f;
+  kernel.gain = tone.gain;
+
+  // Linear attack, then a cubic decay that reaches zero at the end. The
+  // attack gets its own span so the envelope needs no per-sample min().
+  const int attack = std::min(count, static_cast<int>(tone.attack_seconds * static_cast<float>(sample_rate)));
+  float* samples = out.data() + offset;
+  RenderSpan(kernel, 0, attack, 0.0f, attack > 0 ? 1.0f / tone.attack_seconds : 0.0f, samples);
+  RenderSpan(kernel, attack, count, 1.0f, 0.0f, samples);
+}
+
+std::vector<float> RenderEffect(SoundEffect effect, int sample_rate) {
+  std::vector<float> mono;
+  mono.reserve(static_cast<size_t>(sample_rate) / 2);
+  switch (effect) {
+    case SoundEffect::Catch:
+      RenderTone(Tone{880.0f, 1320.0f, 0.12f, 0.004f, 0.6f, Waveform::Sine}, sample_rate, mono);
+      break;
+    case SoundEffect::Miss:
+      RenderTone(Tone{220.0f, 110.0f, 0.22f, 0.006f, 0.5f, Waveform::Triangle}, sample_rate, mono);
+      break;
+    case SoundEffect::Unlock:
+      for (float hz : {523.25f, 659.25f, 783.99f, 1046.5f}) {
+        RenderTone(Tone{hz, hz, 0.1f, 0.004f, 0.55f, Waveform::Sine}, sample_rate, mono);
+      }
+      break;
+  }
+  return mono;
+}
+
+}  // namespace
+
+std::vector<std::int16_t> SynthesizeEffect(SoundEffect effect, int sample_rate, int channels) {
+  const std::vector<float> mono = RenderEffect(effect, std::max(8000, sample_rate));
+  // Every tone peaks below its gain (< 1), so no clamp is needed.
+  const size_t width = static_cast<size_t>(std::max(1, channels));
+  std::vector<std::int16_t> pcm(mono.size() * width);
+  if (width == 2) {
+    // The device is opened in stereo; keep this case a flat, vectorizable loop.
+    for (size_t i = 0; i < mono.size(); ++i) {
+      const auto value = static_cast<std::int16_t>(mono[i] * 32767.0f);
+      pcm[2 * i] = value;
+      pcm[2 * i + 1] = value;
+    }
+    return pcm;
+  }
+  for (size_t i = 0; i < mono.size(); ++i) {
+    const auto value = static_cast<std::int16_t>(mono[i] * 32767.0f);
+    for (size_t c = 0; c < width; ++c) {
+      pcm[i * width + c] = value;
+    }
+  }
+  return pcm;
+}
+
+}  // namespace vday
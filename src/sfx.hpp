@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vday {
+
+enum class SoundEffect {
+  Catch,
+  Miss,
+  Unlock,
+};
+
+// Synthesizes a sound effect as interleaved signed 16-bit PCM. Used when the
+// matching WAV is missing, so every event has a sound without disk I/O.
+std::vector<std::int16_t> SynthesizeEffect(SoundEffect effect, int sample_rate, int channels);
+
+}  // namespace vday
@@ -0,0 +1,237 @@
+#include "shm_ring.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+namespace vday {
+
+namespace {
+
+size_t SlotBytes(std::uint32_t max_notes) {
+  const size_t bytes = sizeof(ShmSlotHeader) + size_t{max_notes} * sizeof(ShmNote);
+  return (bytes + 63) / 64 * 64;
+}
+
+}  // namespace
+
+ShmSnapshotWriter::~ShmSnapshotWriter() {
+  Close();
+}
+
+bool ShmSnapshotWriter::Open(const std::string& name, std::uint32_t max_notes,
+                             std::string& error) {
+  Close();
+#ifdef __linux__
+  const size_t slot_bytes = SlotBytes(max_notes);
+  const size_t size = sizeof(ShmRingHeader) + kShmSlots * slot_bytes;
+  const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    error = "shm_open " + name + ": " + std::strerror(errno);
+    return false;
+  }
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    error = "ftruncate " + name + ": " + std::strerror(errno);
+    close(fd);
+    return false;
+  }
+  void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    error = "mmap " + name + ": " + std::strerror(errno);
+    return false;
+  }
+  base_ = static_cast<unsigned char*>(base);
+  size_ = size;
+  name_ = name;
+  sequence_ = 0;
+
+  // A segment left by a crashed run is reused, so reset it in full. Readers
+  // ignore it until the magic goes back in.
+  auto* header = reinterpret_cast<ShmRingHeader*>(base_);
+  header->magic.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  header->layout_version = kShmLayoutVersion;
+  header->slot_count = kShmSlots;
+  header->slot_bytes = static_cast<std::uint32_t>(slot_bytes);
+  header->max_notes = max_notes;
+  header->latest.store(0, std::memory_order_relaxed);
+  for (size_t i = 0; i < kShmSlots; ++i) {
+    auto* slot = reinterpret_cast<ShmSlotHeader*>(base_ + sizeof(ShmRingHeader) + i * slot_bytes);
+    slot->version.store(0, std::memory_order_relaxed);
+  }
+  header->magic.store(kShmMagic, std::memory_order_release);
+  return true;
+#else
+  (void)name;
+  (void)max_notes;
+  error = "shared-memory snapshots need Linux";
+  return false;
+#endif
+}
+
+void ShmSnapshotWriter::Close() {
+  if (base_ == nullptr) {
+    return;
+  }
+#ifdef __linux__
+  // Readers still mapping this segment see the magic go and look for a new one.
+  reinterpret_cast<ShmRingHeader*>(base_)->magic.store(0, std::memory_order_release);
+  munmap(base_, size_);
+  shm_unlink(name_.c_str());
+#endif
+  base_ = nullptr;
+  size_ = 0;
+}
+
+void ShmSnapshotWriter::Publish(const GameSnapshot& snapshot, size_t first_note,
+                                std::int32_t fall) {
+  if (base_ == nullptr) {
+    return;
+  }
+  auto* header = reinterpret_cast<ShmRingHeader*>(base_);
+  const std::uint64_t sequence = ++sequence_;
+  auto* slot = reinterpret_cast<ShmSlotHeader*>(base_ + sizeof(ShmRingHeader) +
+                                                (sequence % kShmSlots) * header->slot_bytes);
+
+  slot->version.store(2 * sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  const std::uint32_t total = static_cast<std::uint32_t>(snapshot.notes.size() - first_note);
+  const std::uint32_t count = std::min(total, header->max_notes);
+  ShmFrame& frame = slot->frame;
+  frame.sequence = sequence;
+  frame.width = snapshot.width;
+  frame.height = snapshot.height;
+  frame.player_x = snapshot.player_x;
+  frame.score = snapshot.score;
+  frame.streak = snapshot.streak;
+  frame.misses = snapshot.misses;
+  frame.unlocked_chunks = snapshot.unlocked_chunks;
+  frame.catcher_flash_frames = snapshot.catcher_flash_frames;
+  frame.paused = snapshot.paused ? 1 : 0;
+  frame.tick_rate = snapshot.tick_rate;
+  frame.interpolation_alpha = snapshot.interpolation_alpha;
+  frame.note_count = count;
+  frame.total_notes = total;
+  frame.reserved = 0;
+  auto* notes = reinterpret_cast<ShmNote*>(slot + 1);
+  for (std::uint32_t i = 0; i < count; ++i) {
+    const Note& note = snapshot.notes[first_note + i];
+    notes[i] = ShmNote{note.x, note.y + fall, static_cast<std::int32_t>(note.type)};
+  }
+
+  slot->version.store(2 * sequence + 2, std::memory_order_release);
+  header->latest.store(sequence, std::memory_order_release);
+}
+
+ShmSnapshotReader::~ShmSnapshotReader() {
+  Close();
+}
+
+bool ShmSnapshotReader::Open(const std::string& name, std::string& error) {
+  Close();
+  // Kept across a failed open, so reads keep trying until a writer is back.
+  name_ = name;
+#ifdef __linux__
+  const int fd = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+  if (fd < 0) {
+    error = "shm_open " + name + ": " + std::strerror(errno);
+    return false;
+  }
+  struct stat info{};
+  if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(ShmRingHeader)) {
+    error = name + " is not a snapshot ring";
+    close(fd);
+    return false;
+  }
+  const size_t size = static_cast<size_t>(info.st_size);
+  void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    error = "mmap " + name + ": " + std::strerror(errno);
+    return false;
+  }
+  const auto* header = static_cast<const ShmRingHeader*>(base);
+  const bool magic = header->magic.load(std::memory_order_acquire) == kShmMagic;
+  const std::uint32_t slot_count = header->slot_count;
+  const std::uint32_t slot_bytes = header->slot_bytes;
+  const std::uint32_t max_notes = header->max_notes;
+  const bool valid = magic && header->layout_version == kShmLayoutVersion && slot_count > 0 &&
+                     slot_bytes >= SlotBytes(max_notes) &&
+                     sizeof(ShmRingHeader) + size_t{slot_count} * slot_bytes <= size;
+  if (!valid) {
+    error = name + " has an unknown layout or is still being set up";
+    munmap(base, size);
+    return false;
+  }
+  header_ = header;
+  size_ = size;
+  slot_count_ = slot_count;
+  slot_bytes_ = slot_bytes;
+  max_notes_ = max_notes;
+  return true;
+#else
+  (void)name;
+  error = "shared-memory snapshots need Linux";
+  return false;
+#endif
+}
+
+void ShmSnapshotReader::Close() {
+  name_.clear();
+  if (header_ == nullptr) {
+    return;
+  }
+#ifdef __linux__
+  munmap(const_cast<ShmRingHeader*>(header_), size_);
+#endif
+  header_ = nullptr;
+  size_ = 0;
+}
+
+bool ShmSnapshotReader::Reopen() {
+  if (name_.empty()) {
+    return false;
+  }
+  const std::string name = name_;
+  std::string error;
+  return Open(name, error);
+}
+
+bool ShmSnapshotReader::ReadLatest(GameSnapshot& out, std::uint64_t* sequence) {
+  std::uint64_t read_sequence = 0;
+  const bool ok = VisitLatest([&](const ShmFrame& frame, const ShmNote* notes, std::uint32_t count) {
+    read_sequence = frame.sequence;
+    out.width = frame.width;
+    out.height = frame.height;
+    out.player_x = frame.player_x;
+    out.score = frame.score;
+    out.streak = frame.streak;
+    out.misses = frame.misses;
+    out.unlocked_chunks = frame.unlocked_chunks;
+    out.catcher_flash_frames = frame.catcher_flash_frames;
+    out.paused = frame.paused != 0;
+    out.tick_rate = frame.tick_rate;
+    out.interpolation_alpha = frame.interpolation_alpha;
+    out.notes.resize(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+      // A torn type is harmless here: the copy is discarded on a retry.
+      out.notes[i] = Note{notes[i].x, notes[i].y, static_cast<ItemType>(notes[i].type)};
+    }
+  });
+  if (ok && sequence != nullptr) {
+    *sequence = read_sequence;
+  }
+  return ok;
+}
+
+}  // namespace vday
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "game.hpp"
+
+namespace vday {
+
+// Layout of the shared-memory snapshot ring. All fields are native-endian and
+// the structs below are the wire format; bump kShmLayoutVersion on any change.
+//
+//   ShmRingHeader                       (128 bytes)
+//   slot[0] .. slot[slot_count - 1]     (slot_bytes each)
+//     ShmSlotHeader                     (128 bytes)
+//     ShmNote[max_notes]
+//
+// Each slot is guarded by its own version counter: odd while the writer fills
+// it, 2 * sequence + 2 once frame `sequence` is complete. The writer fills
+// slot sequence % slot_count, then advances ShmRingHeader::latest, so a reader
+// on the newest slot is only disturbed after slot_count - 1 further frames.
+inline constexpr std::uint32_t kShmMagic = 0x48534456;  // "VDSH"
+inline constexpr std::uint16_t kShmLayoutVersion = 2;
+inline constexpr std::uint16_t kShmSlots = 4;
+inline constexpr char kDefaultShmName[] = "/valentine_tui";
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "the ring's counters must be usable across processes");
+
+struct ShmNote {
+  std::int32_t x;
+  std::int32_t y;     // fixed point, kNoteRowUnits per row
+  std::int32_t type;  // ItemType
+};
+
+struct ShmFrame {
+  std::uint64_t sequence;
+  std::int32_t width;
+  std::int32_t height;
+  std::int32_t player_x;
+  std::int32_t score;
+  std::int32_t streak;
+  std::int32_t misses;
+  std::int32_t unlocked_chunks;
+  std::int32_t catcher_flash_frames;
+  std::int32_t paused;
+  std::int32_t tick_rate;
+  float interpolation_alpha;
+  // Notes stored in the slot; total_notes is larger when the board held more
+  // than max_notes.
+  std::uint32_t note_count;
+  std::uint32_t total_notes;
+  std::uint32_t reserved;
+};
+
+struct ShmSlotHeader {
+  alignas(64) std::atomic<std::uint64_t> version;
+  alignas(64) ShmFrame frame;
+};
+
+struct ShmRingHeader {
+  // Written last when the writer (re)initializes the segment.
+  std::atomic<std::uint32_t> magic;
+  std::uint16_t layout_version;
+  std::uint16_t slot_count;
+  std::uint32_t slot_bytes;
+  std::uint32_t max_notes;
+  // Sequence of the newest complete frame; 0 before the first. Kept on its
+  // own line, since every reader polls it.
+  alignas(64) std::atomic<std::uint64_t> latest;
+};
+
+static_assert(sizeof(ShmNote) == 12);
+static_assert(sizeof(ShmFrame) == 64);
+static_assert(sizeof(ShmSlotHeader) == 128);
+static_assert(sizeof(ShmRingHeader) == 128);
+
+// Creates the segment and publishes into it. Publish is a few memcpys and
+// atomic stores with no syscalls, and costs the same however many readers
+// are attached. Single writer only.
+class ShmSnapshotWriter {
+ public:
+  ShmSnapshotWriter() = default;
+  ~ShmSnapshotWriter();
+  ShmSnapshotWriter(const ShmSnapshotWriter&) = delete;
+  ShmSnapshotWriter& operator=(const ShmSnapshotWriter&) = delete;
+
+  // `name` is a shm_open name such as "/valentine_tui". Returns false with a
+  // message in `error` on failure. A no-op failure off Linux.
+  bool Open(const std::string& name, std::uint32_t max_notes, std::string& error);
+  // Unmaps and unlinks; readers that still have it mapped keep the last frame.
+  void Close();
+  bool is_open() const { return base_ != nullptr; }
+
+  // Notes before `first_note` are left out and the rest are published `fall`
+  // lower, as with EncodeState().
+  void Publish(const GameSnapshot& snapshot, size_t first_note = 0, std::int32_t fall = 0);
+
+ private:
+  std::string name_;
+  unsigned char* base_ = nullptr;
+  size_t size_ = 0;
+  std::uint64_t sequence_ = 0;
+};
+
+// Maps a writer's segment read-only. Reading never enters the kernel while
+// the writer keeps the segment; when it closes or re-creates it, the next
+// read notices the magic or layout change and maps the segment again.
+class ShmSnapshotReader {
+ public:
+  ShmSnapshotReader() = default;
+  ~ShmSnapshotReader();
+  ShmSnapshotReader(const ShmSnapshotReader&) = delete;
+  ShmSnapshotReader& operator=(const ShmSnapshotReader&) = delete;
+
+  bool Open(const std::string& name, std::string& error);
+  void Close();
+  bool is_open() const { return header_ != nullptr; }
+
+  // Newest complete sequence, 0 if nothing was published yet.
+  std::uint64_t LatestSequence() const {
+    return header_ == nullptr ? 0 : header_->latest.load(std::memory_order_acquire);
+  }
+
+  // Calls visit(frame, notes, note_count) on the newest frame where it lies in the
+  // mapping, without copying it. The writer may overwrite the slot during the
+  // call, so `visit` must only read, and must tolerate garbage. Its work only
+  // counts when this returns true. Returns false if nothing is published, if
+  // the segment went away, or if every retry collided with the writer.
+  template <typename Visit>
+  bool VisitLatest(Visit&& visit) {
+    if (!EnsureCurrent()) {
+      return false;
+    }
+    for (int attempt = 0; attempt < kMaxAttempts; ++attempt) {
+      const std::uint64_t sequence = header_->latest.load(std::memory_order_acquire);
+      if (sequence == 0) {
+        return false;
+      }
+      const ShmSlotHeader& slot = Slot(sequence);
+      const std::uint64_t before = slot.version.load(std::memory_order_acquire);
+      if (before != 2 * sequence + 2) {
+        continue;  // lapped by the writer; take the newer frame instead
+      }
+      const std::uint32_t count = std::min(slot.frame.note_count, max_notes_);
+      visit(slot.frame, reinterpret_cast<const ShmNote*>(&slot + 1), count);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.version.load(std::memory_order_relaxed) == before) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Copies the newest frame into `out` and its sequence into `sequence`.
+  bool ReadLatest(GameSnapshot& out, std::uint64_t* sequence = nullptr);
+
+ private:
+  static constexpr int kMaxAttempts = 16;
+
+  // The layout is copied at Open() and only the copies index the mapping, so
+  // a writer rewriting the header cannot send a read past the mapped size.
+  bool Current() const {
+    return header_->magic.load(std::memory_order_acquire) == kShmMagic &&
+           header_->layout_version == kShmLayoutVersion && header_->slot_count == slot_count_ &&
+           header_->slot_bytes == slot_bytes_ && header_->max_notes == max_notes_;
+  }
+  bool EnsureCurrent() { return (header_ != nullptr && Current()) || Reopen(); }
+  bool Reopen();
+
+  const ShmSlotHeader& Slot(std::uint64_t sequence) const {
+    const auto* slots = reinterpret_cast<const unsigned char*>(header_ + 1);
+    return *reinterpret_cast<const ShmSlotHeader*>(slots + (sequence % slot_count_) * slot_bytes_);
+  }
+
+  std::string name_;
+  const ShmRingHeader* header_ = nullptr;
+  size_t size_ = 0;
+  std::uint32_t slot_count_ = 0;
+  std::uint32_t slot_bytes_ = 0;
+  std::uint32_t max_notes_ = 0;
+};
+
+}  // namespace vday
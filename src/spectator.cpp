@@ -0,0 +1,682 @@
+#include "spectator.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <type_traits>
+
+#include <ftxui/component/component.hpp>
+#include <ftxui/component/screen_interactive.hpp>
+#include <ftxui/dom/elements.hpp>
+
+#include "board.hpp"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+namespace vday {
+
+namespace {
+
+static_assert(sizeof(SpectatorFrameHeader) == 16);
+static_assert(std::is_trivially_copyable_v<SpectatorFrameHeader>);
+
+// Anything larger is a corrupt stream, not a board.
+constexpr std::uint32_t kMaxPayloadBytes = 64u << 20;
+
+template <typename T>
+void Put(std::vector<std::uint8_t>& out, const T& value) {
+  const size_t offset = out.size();
+  out.resize(offset + sizeof(T));
+  std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+struct Reader {
+  const std::uint8_t* data;
+  const std::uint8_t* end;
+
+  template <typename T>
+  bool Get(T& value) {
+    if (static_cast<size_t>(end - data) < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return true;
+  }
+
+  size_t remaining() const { return static_cast<size_t>(end - data); }
+};
+
+using WireNote = SpectatorEncoder::WireNote;
+using WireState = SpectatorEncoder::WireState;
+
+void ToWire(const GameSnapshot& snapshot, WireState& out) {
+  out.fields = {snapshot.width,
+                snapshot.height,
+                snapshot.player_x,
+                snapshot.score,
+                snapshot.streak,
+                snapshot.misses,
+                snapshot.unlocked_chunks,
+                snapshot.catcher_flash_frames,
+                snapshot.paused ? 1 : 0};
+  out.notes.resize(snapshot.notes.size());
+  for (size_t i = 0; i < snapshot.notes.size(); ++i) {
+    const Note& note = snapshot.notes[i];
+    out.notes[i] = WireNote{note.x, note.y / (kNoteRowUnits / kSpectatorRowScale),
+                            static_cast<std::int32_t>(note.type)};
+  }
+}
+
+void FromWire(const WireState& state, GameSnapshot& out) {
+  out.width = state.fields[0];
+  out.height = state.fields[1];
+  out.player_x = state.fields[2];
+  out.score = state.fields[3];
+  out.streak = state.fields[4];
+  out.misses = state.fields[5];
+  out.unlocked_chunks = state.fields[6];
+  out.catcher_flash_frames = state.fields[7];
+  out.paused = state.fields[8] != 0;
+  out.notes.resize(state.notes.size());
+  for (size_t i = 0; i < state.notes.size(); ++i) {
+    const WireNote& note = state.notes[i];
+    out.notes[i] = Note{note.x, note.y * (kNoteRowUnits / kSpectatorRowScale),
+                        static_cast<ItemType>(note.type)};
+  }
+}
+
+bool ValidType(std::int32_t type) {
+  return type >= 0 && type < static_cast<std::int32_t>(kItems.size());
+}
+
+// Notes leave the board from the front of the list (the oldest are lowest)
+// and spawn at the back, so the survivors are a suffix of `previous` and a
+// prefix of `current`. Returns how many left; everything, if nothing lines up.
+size_t CountRemoved(const std::vector<WireNote>& previous, const std::vector<WireNote>& current) {
+  for (size_t removed = 0; removed < previous.size(); ++removed) {
+    const size_t kept = previous.size() - removed;
+    if (kept > current.size()) {
+      continue;
+    }
+    bool match = true;
+    for (size_t i = 0; i < kept && match; ++i) {
+      const WireNote& before = previous[removed + i];
+      const WireNote& after = current[i];
+      const std::int32_t dy = after.y - before.y;
+      match = before.x == after.x && before.type == after.type &&
+              dy >= std::numeric_limits<std::int8_t>::min() &&
+              dy <= std::numeric_limits<std::int8_t>::max();
+    }
+    if (match) {
+      return removed;
+    }
+  }
+  return previous.size();
+}
+
+}  // namespace
+
+std::string DefaultSpectatorSocket() {
+  if (const char* runtime = std::getenv("XDG_RUNTIME_DIR"); runtime != nullptr && *runtime) {
+    return std::string(runtime) + "/valentine_tui.sock";
+  }
+#ifdef __linux__
+  return "/tmp/valentine_tui-" + std::to_string(getuid()) + ".sock";
+#else
+  return "/tmp/valentine_tui.sock";
+#endif
+}
+
+bool SpectatorEncoder::Update(const GameSnapshot& snapshot) {
+  // previous_ is only needed for the delta, which is already encoded, so its
+  // storage takes the new frame.
+  ToWire(snapshot, previous_);
+  if (sequence_ > 0 && previous_.fields == current_.fields && previous_.notes == current_.notes) {
+    return false;
+  }
+  std::swap(previous_, current_);
+  has_delta_ = sequence_ > 0;
+  sequence_++;
+  keyframe_ready_ = false;
+  if (has_delta_) {
+    EncodeDelta();
+  }
+  return true;
+}
+
+void SpectatorEncoder::EncodeDelta() {
+  delta_.clear();
+  std::uint16_t mask = 0;
+  for (size_t i = 0; i < kFieldCount; ++i) {
+    if (previous_.fields[i] != current_.fields[i]) {
+      mask |= static_cast<std::uint16_t>(1u << i);
+    }
+  }
+  Put(delta_, mask);
+  for (size_t i = 0; i < kFieldCount; ++i) {
+    if (mask & (1u << i)) {
+      Put(delta_, current_.fields[i]);
+    }
+  }
+
+  const size_t removed = CountRemoved(previous_.notes, current_.notes);
+  const size_t kept = previous_.notes.size() - removed;
+  Put(delta_, static_cast<std::uint32_t>(removed));
+  Put(delta_, static_cast<std::uint32_t>(current_.notes.size() - kept));
+  for (size_t i = 0; i < kept; ++i) {
+    Put(delta_, static_cast<std::int8_t>(current_.notes[i].y - previous_.notes[removed + i].y));
+  }
+  for (size_t i = kept; i < current_.notes.size(); ++i) {
+    Put(delta_, current_.notes[i]);
+  }
+}
+
+const std::vector<std::uint8_t>& SpectatorEncoder::Keyframe() {
+  if (!keyframe_ready_) {
+    keyframe_.clear();
+    for (std::int32_t field : current_.fields) {
+      Put(keyframe_, field);
+    }
+    Put(keyframe_, static_cast<std::uint32_t>(current_.notes.size()));
+    for (const WireNote& note : current_.notes) {
+      Put(keyframe_, note);
+    }
+    keyframe_ready_ = true;
+  }
+  return keyframe_;
+}
+
+bool SpectatorDecoder::Feed(const std::uint8_t* data, size_t size) {
+  buffer_.insert(buffer_.end(), data, data + size);
+  size_t offset = 0;
+  bool ok = true;
+  while (buffer_.size() - offset >= sizeof(SpectatorFrameHeader)) {
+    SpectatorFrameHeader header;
+    std::memcpy(&header, buffer_.data() + offset, sizeof(header));
+    if (header.magic != kSpectatorMagic || header.payload_bytes > kMaxPayloadBytes) {
+      ok = false;
+      break;
+    }
+    const size_t frame_bytes = sizeof(header) + header.payload_bytes;
+    if (buffer_.size() - offset < frame_bytes) {
+      break;
+    }
+    if (!Apply(header, buffer_.data() + offset + sizeof(header))) {
+      ok = false;
+      break;
+    }
+    offset += frame_bytes;
+  }
+  buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(offset));
+  return ok;
+}
+
+bool SpectatorDecoder::Apply(const SpectatorFrameHeader& header, const std::uint8_t* payload) {
+  Reader reader{payload, payload + header.payload_bytes};
+  if (header.kind == SpectatorFrameKind::Keyframe) {
+    std::uint32_t count = 0;
+    for (auto& field : state_.fields) {
+      if (!reader.Get(field)) {
+        return false;
+      }
+    }
+    if (!reader.Get(count) || reader.remaining() != count * sizeof(WireNote)) {
+      return false;
+    }
+    state_.notes.resize(count);
+    for (auto& note : state_.notes) {
+      reader.Get(note);
+      if (!ValidType(note.type)) {
+        return false;
+      }
+    }
+    synced_ = true;
+    keyframes_++;
+  } else if (header.kind == SpectatorFrameKind::Delta) {
+    // A gap means a frame went missing; wait for the next keyframe.
+    if (!synced_ || header.sequence != sequence_ + 1) {
+      synced_ = false;
+      return true;
+    }
+    std::uint16_t mask = 0;
+    if (!reader.Get(mask)) {
+      return false;
+    }
+    for (size_t i = 0; i < SpectatorEncoder::kFieldCount; ++i) {
+      if ((mask & (1u << i)) && !reader.Get(state_.fields[i])) {
+        return false;
+      }
+    }
+    std::uint32_t removed = 0;
+    std::uint32_t appended = 0;
+    if (!reader.Get(removed) || !reader.Get(appended) || removed > state_.notes.size()) {
+      return false;
+    }
+    const size_t kept = state_.notes.size() - removed;
+    if (reader.remaining() != kept * sizeof(std::int8_t) + appended * sizeof(WireNote)) {
+      return false;
+    }
+    state_.notes.erase(state_.notes.begin(),
+                       state_.notes.begin() + static_cast<std::ptrdiff_t>(removed));
+    for (auto& note : state_.notes) {
+      std::int8_t dy = 0;
+      reader.Get(dy);
+      note.y += dy;
+    }
+    for (std::uint32_t i = 0; i < appended; ++i) {
+      WireNote note;
+      reader.Get(note);
+      if (!ValidType(note.type)) {
+        return false;
+      }
+      state_.notes.push_back(note);
+    }
+    deltas_++;
+  } else {
+    return false;
+  }
+  sequence_ = header.sequence;
+  FromWire(state_, snapshot_);
+  return true;
+}
+
+SpectatorServer::SpectatorServer() = default;
+
+SpectatorServer::~SpectatorServer() {
+  Stop();
+}
+
+bool SpectatorServer::Start(const std::string& path, GameEngine& engine, int fps,
+                            std::string& error) {
+  if (running_) {
+    return true;
+  }
+#ifdef __linux__
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+    error = "spectator socket path is empty or too long: " + path;
+    return false;
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+  // Only ever remove a socket left behind by an earlier run: one that still
+  // accepts connections belongs to a running game.
+  struct stat info{};
+  if (lstat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+    const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (probe < 0) {
+      error = std::string("socket: ") + std::strerror(errno);
+      return false;
+    }
+    const int connected =
+        connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    const int probe_errno = errno;
+    close(probe);
+    if (connected == 0 || probe_errno != ECONNREFUSED) {
+      error = path + " is already in use" +
+              (connected == 0 ? std::string() : std::string(": ") + std::strerror(probe_errno));
+      return false;
+    }
+    unlink(path.c_str());
+  }
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listen_fd_ < 0 ||
+      bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+      listen(listen_fd_, 8) != 0) {
+    error = "cannot listen on " + path + ": " + std::strerror(errno);
+    if (listen_fd_ >= 0) {
+      close(listen_fd_);
+      listen_fd_ = -1;
+    }
+    return false;
+  }
+  wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (wake_fd_ < 0) {
+    error = std::string("eventfd: ") + std::strerror(errno);
+    close(listen_fd_);
+    listen_fd_ = -1;
+    unlink(path.c_str());
+    return false;
+  }
+  engine_ = &engine;
+  path_ = path;
+  period_ = std::chrono::microseconds(1000000 / std::max(1, fps));
+  running_ = true;
+  thread_ = std::thread(&SpectatorServer::RunLoop, this);
+  return true;
+#else
+  (void)path;
+  (void)engine;
+  (void)fps;
+  error = "spectator streaming needs Linux";
+  return false;
+#endif
+}
+
+void SpectatorServer::Stop() {
+  if (!running_) {
+    return;
+  }
+  running_ = false;
+#ifdef __linux__
+  const std::uint64_t one = 1;
+  (void)!write(wake_fd_, &one, sizeof(one));
+#endif
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+#ifdef __linux__
+  for (auto& client : clients_) {
+    close(client.fd);
+  }
+  clients_.clear();
+  close(listen_fd_);
+  close(wake_fd_);
+  listen_fd_ = -1;
+  wake_fd_ = -1;
+  unlink(path_.c_str());
+#endif
+}
+
+std::string SpectatorServer::Summary() const {
+  std::ostringstream out;
+  out << "spectators: " << accepted_.load() << " connected, " << frames_sent_.load()
+      << " frames (" << keyframes_sent_.load() << " keyframes), " << frames_skipped_.load()
+      << " skipped, " << clients_dropped_.load() << " dropped, " << bytes_sent_.load()
+      << " bytes";
+  return out.str();
+}
+
+void SpectatorServer::RunLoop() {
+#ifdef __linux__
+  using Clock = std::chrono::steady_clock;
+  std::vector<pollfd> fds;
+  auto next_frame = Clock::now();
+
+  while (running_) {
+    fds.clear();
+    fds.push_back({listen_fd_, POLLIN, 0});
+    fds.push_back({wake_fd_, POLLIN, 0});
+    for (const auto& client : clients_) {
+      // Hangups are reported whatever the requested events.
+      fds.push_back({client.fd, static_cast<short>(client.pending.empty() ? 0 : POLLOUT), 0});
+    }
+    int timeout_ms = -1;
+    if (!clients_.empty()) {
+      const auto wait = std::chrono::ceil<std::chrono::milliseconds>(next_frame - Clock::now());
+      timeout_ms = static_cast<int>(std::max<std::int64_t>(0, wait.count()));
+    }
+    const int ready = poll(fds.data(), fds.size(), timeout_ms);
+    if (ready < 0 && errno != EINTR) {
+      break;
+    }
+    if (fds[1].revents & POLLIN) {
+      break;
+    }
+    // Poll slots line up with clients_ until Accept appends to it.
+    for (size_t i = 0; i < clients_.size() && ready > 0; ++i) {
+      const short revents = fds[i + 2].revents;
+      if (revents & (POLLHUP | POLLERR | POLLNVAL)) {
+        Drop(clients_[i]);
+      } else if (revents & POLLOUT) {
+        Flush(clients_[i]);
+      }
+    }
+    if (ready > 0 && (fds[0].revents & POLLIN)) {
+      const bool had_clients = !clients_.empty();
+      Accept();
+      if (!had_clients) {
+        // Sampling stopped while nobody watched; start again right away.
+        next_frame = Clock::now();
+      }
+    }
+
+    const auto now = Clock::now();
+    if (!clients_.empty() && now >= next_frame) {
+      next_frame += period_;
+      if (next_frame < now) {
+        next_frame = now + period_;
+      }
+      encoder_.Update(engine_->Snapshot());
+      for (auto& client : clients_) {
+        if (client.closed || client.sent_sequence == encoder_.sequence()) {
+          continue;
+        }
+        if (!client.pending.empty()) {
+          frames_skipped_++;
+          if (++client.stalled_frames * period_ >= std::chrono::seconds(kMaxStalledSeconds)) {
+            Drop(client);
+          }
+          continue;
+        }
+        Deliver(client);
+      }
+    }
+    clients_.erase(std::remove_if(clients_.begin(), clients_.end(),
+                                  [](const Client& client) { return client.closed; }),
+                   clients_.end());
+  }
+#endif
+}
+
+void SpectatorServer::Accept() {
+#ifdef __linux__
+  int fd = -1;
+  while ((fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+    Client client;
+    client.fd = fd;
+    clients_.push_back(std::move(client));
+    accepted_++;
+  }
+#endif
+}
+
+void SpectatorServer::Deliver(Client& client) {
+#ifdef __linux__
+  // A client that missed the previous frame, or any client on a keyframe
+  // boundary, gets the whole board.
+  const bool delta = encoder_.has_delta() && client.sent_sequence + 1 == encoder_.sequence() &&
+                     encoder_.sequence() % kKeyframeEvery != 0;
+  const std::vector<std::uint8_t>& payload = delta ? encoder_.Delta() : encoder_.Keyframe();
+  SpectatorFrameHeader header;
+  header.kind = delta ? SpectatorFrameKind::Delta : SpectatorFrameKind::Keyframe;
+  header.sequence = encoder_.sequence();
+  header.payload_bytes = static_cast<std::uint32_t>(payload.size());
+
+  // One gathered send per frame; MSG_NOSIGNAL turns a vanished reader into
+  // EPIPE rather than SIGPIPE, which writev cannot.
+  iovec iov[2] = {{&header, sizeof(header)},
+                  {const_cast<std::uint8_t*>(payload.data()), payload.size()}};
+  msghdr message{};
+  message.msg_iov = iov;
+  message.msg_iovlen = payload.empty() ? 1 : 2;
+  ssize_t written = sendmsg(client.fd, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+  if (written < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      Drop(client);
+      return;
+    }
+    written = 0;
+  }
+  const size_t total = sizeof(header) + payload.size();
+  const size_t done = static_cast<size_t>(written);
+  bytes_sent_ += done;
+  frames_sent_++;
+  if (!delta) {
+    keyframes_sent_++;
+  }
+  client.sent_sequence = encoder_.sequence();
+  client.stalled_frames = 0;
+  if (done < total) {
+    // Keep only the unsent tail of this one frame.
+    client.pending.clear();
+    client.pending_offset = 0;
+    const auto* header_bytes = reinterpret_cast<const std::uint8_t*>(&header);
+    if (done < sizeof(header)) {
+      client.pending.insert(client.pending.end(), header_bytes + done,
+                            header_bytes + sizeof(header));
+      client.pending.insert(client.pending.end(), payload.begin(), payload.end());
+    } else {
+      client.pending.insert(client.pending.end(),
+                            payload.begin() + static_cast<std::ptrdiff_t>(done - sizeof(header)),
+                            payload.end());
+    }
+  }
+#else
+  (void)client;
+#endif
+}
+
+void SpectatorServer::Flush(Client& client) {
+#ifdef __linux__
+  while (client.pending_offset < client.pending.size()) {
+    const ssize_t written =
+        send(client.fd, client.pending.data() + client.pending_offset,
+             client.pending.size() - client.pending_offset, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (written < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        Drop(client);
+      }
+      return;
+    }
+    client.pending_offset += static_cast<size_t>(written);
+    bytes_sent_ += static_cast<std::uint64_t>(written);
+  }
+  client.pending.clear();
+  client.pending_offset = 0;
+  client.stalled_frames = 0;
+#else
+  (void)client;
+#endif
+}
+
+void SpectatorServer::Drop(Client& client) {
+  if (client.closed) {
+    return;
+  }
+#ifdef __linux__
+  close(client.fd);
+#endif
+  client.fd = -1;
+  client.closed = true;
+  clients_dropped_++;
+}
+
+int RunSpectator(const std::string& path) {
+#ifdef __linux__
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    std::fprintf(stderr, "Spectator socket path too long: %s\n", path.c_str());
+    return 1;
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+    std::fprintf(stderr, "Cannot connect to %s: %s\n", path.c_str(), std::strerror(errno));
+    if (fd >= 0) {
+      close(fd);
+    }
+    return 1;
+  }
+
+  using namespace ftxui;
+  auto screen = ScreenInteractive::Fullscreen();
+  std::mutex mutex;
+  GameSnapshot latest;
+  bool have_frame = false;
+  std::string status = "Waiting for the first keyframe...";
+  std::atomic<bool> running{true};
+
+  std::thread reader([&] {
+    SpectatorDecoder decoder;
+    std::uint8_t buffer[16384];
+    std::string end_status = "Game closed the stream.";
+    while (running) {
+      const ssize_t length = recv(fd, buffer, sizeof(buffer), 0);
+      if (length <= 0) {
+        if (length < 0 && errno == EINTR) {
+          continue;
+        }
+        break;
+      }
+      if (!decoder.Feed(buffer, static_cast<size_t>(length))) {
+        end_status = "Malformed stream; disconnected.";
+        break;
+      }
+      if (decoder.synced()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        latest = decoder.snapshot();
+        have_frame = true;
+        status = "Frame " + std::to_string(decoder.sequence()) + "  keyframes " +
+                 std::to_string(decoder.keyframes()) + "  deltas " +
+                 std::to_string(decoder.deltas());
+      }
+      screen.PostEvent(Event::Custom);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      status = end_status;
+    }
+    screen.PostEvent(Event::Custom);
+  });
+
+  auto view = Renderer([&] {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto board = have_frame ? RenderGameCanvas(latest) : text("No board yet");
+    auto stats = hbox({
+        text("Score: " + std::to_string(latest.score)),
+        text("  Streak: " + std::to_string(latest.streak)),
+        text("  Misses: " + std::to_string(latest.misses)),
+        latest.paused ? text("  [PAUSED]") | bold : text(""),
+    });
+    return vbox({
+               text("Spectating " + path) | bold | center,
+               separator(),
+               board | center,
+               separator(),
+               stats | center,
+               text(status) | center,
+               text("Esc/Q quit") | center,
+           }) |
+           border;
+  });
+  view = CatchEvent(view, [&](Event event) {
+    if (event == Event::Escape || event == Event::Character('q') ||
+        event == Event::Character('Q')) {
+      screen.Exit();
+      return true;
+    }
+    return false;
+  });
+
+  screen.Loop(view);
+  running = false;
+  // Unblocks the reader's recv.
+  shutdown(fd, SHUT_RDWR);
+  reader.join();
+  close(fd);
+  return 0;
+#else
+  std::fprintf(stderr, "Spectating needs Linux (%s)\n", path.c_str());
+  return 1;
+#endif
+}
+
+}  // namespace vday
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game.hpp"
+
+namespace vday {
+
+// Spectator stream: a sequence of frames on a Unix socket, each a fixed
+// SpectatorFrameHeader followed by its payload. A keyframe carries the whole
+// board; a delta carries the changed scalars, how many of the oldest notes are
+// gone, how far every remaining note moved, and the notes spawned since.
+// Note rows travel in fixed point, 1/kSpectatorRowScale of a row.
+inline constexpr std::uint32_t kSpectatorMagic = 0x50534456;  // "VDSP"
+inline constexpr int kSpectatorRowScale = 64;
+
+enum class SpectatorFrameKind : std::uint8_t {
+  Keyframe = 0,
+  Delta = 1,
+};
+
+struct SpectatorFrameHeader {
+  std::uint32_t magic = kSpectatorMagic;
+  SpectatorFrameKind kind = SpectatorFrameKind::Keyframe;
+  std::uint8_t reserved[3] = {};
+  std::uint32_t sequence = 0;
+  std::uint32_t payload_bytes = 0;
+};
+
+// $XDG_RUNTIME_DIR/valentine_tui.sock, else a per-user path in /tmp.
+std::string DefaultSpectatorSocket();
+
+// Turns successive snapshots into keyframe and delta payloads. Deltas are
+// always relative to the previous Update that changed something.
+class SpectatorEncoder {
+ public:
+  // Returns false, and keeps the previous frame, when nothing a spectator
+  // sees has changed.
+  bool Update(const GameSnapshot& snapshot);
+
+  std::uint32_t sequence() const { return sequence_; }
+  // False only for the first frame, which has nothing to be relative to.
+  bool has_delta() const { return has_delta_; }
+  const std::vector<std::uint8_t>& Delta() const { return delta_; }
+  // Built on first use for each frame.
+  const std::vector<std::uint8_t>& Keyframe();
+
+  struct WireNote {
+    std::int32_t x;
+    std::int32_t y;  // fixed point
+    std::int32_t type;
+
+    bool operator==(const WireNote&) const = default;
+  };
+  static constexpr size_t kFieldCount = 9;
+  struct WireState {
+    std::array<std::int32_t, kFieldCount> fields{};
+    std::vector<WireNote> notes;
+  };
+
+ private:
+  void EncodeDelta();
+
+  WireState previous_;
+  WireState current_;
+  std::uint32_t sequence_ = 0;
+  bool has_delta_ = false;
+  bool keyframe_ready_ = false;
+  std::vector<std::uint8_t> delta_;
+  std::vector<std::uint8_t> keyframe_;
+};
+
+// Rebuilds snapshots from a byte stream, however it is split into reads.
+class SpectatorDecoder {
+ public:
+  // Returns false on a malformed stream.
+  bool Feed(const std::uint8_t* data, size_t size);
+
+  // True once a keyframe has arrived; deltas before it are ignored.
+  bool synced() const { return synced_; }
+  const GameSnapshot& snapshot() const { return snapshot_; }
+  std::uint32_t sequence() const { return sequence_; }
+  std::uint64_t keyframes() const { return keyframes_; }
+  std::uint64_t deltas() const { return deltas_; }
+
+ private:
+  bool Apply(const SpectatorFrameHeader& header, const std::uint8_t* payload);
+
+  std::vector<std::uint8_t> buffer_;
+  SpectatorEncoder::WireState state_;
+  GameSnapshot snapshot_;
+  std::uint32_t sequence_ = 0;
+  std::uint64_t keyframes_ = 0;
+  std::uint64_t deltas_ = 0;
+  bool synced_ = false;
+};
+
+// Streams an engine's snapshots to any number of local spectators from its
+// own thread, sampling with GameEngine::Snapshot() like the UI does, so the
+// tick loop never waits on a spectator. Each client holds at most one
+// partially written frame. While it does, newer frames are skipped for it,
+// and once it catches up it gets a keyframe. A client stuck for
+// kMaxStalledSeconds is disconnected. A no-op on platforms other than Linux.
+class SpectatorServer {
+ public:
+  static constexpr int kKeyframeEvery = 60;
+  static constexpr int kMaxStalledSeconds = 3;
+
+  SpectatorServer();
+  ~SpectatorServer();
+
+  // Binds `path`, replacing a stale socket file. Returns false with a message
+  // in `error` when it cannot listen.
+  bool Start(const std::string& path, GameEngine& engine, int fps, std::string& error);
+  void Stop();
+
+  // Counters for the thread report.
+  std::string Summary() const;
+
+ private:
+  struct Client {
+    int fd = -1;
+    std::vector<std::uint8_t> pending;
+    size_t pending_offset = 0;
+    // Sequence of the last frame queued in full; 0 before the first.
+    std::uint32_t sent_sequence = 0;
+    int stalled_frames = 0;
+    bool closed = false;
+  };
+
+  void RunLoop();
+  void Accept();
+  void Deliver(Client& client);
+  void Flush(Client& client);
+  void Drop(Client& client);
+
+  GameEngine* engine_ = nullptr;
+  std::string path_;
+  std::chrono::microseconds period_{0};
+  std::atomic<bool> running_{false};
+  std::thread thread_;
+  int listen_fd_ = -1;
+  int wake_fd_ = -1;
+  // Owned by the server thread.
+  std::vector<Client> clients_;
+  SpectatorEncoder encoder_;
+
+  std::atomic<std::uint64_t> accepted_{0};
+  std::atomic<std::uint64_t> frames_sent_{0};
+  std::atomic<std::uint64_t> keyframes_sent_{0};
+  std::atomic<std::uint64_t> frames_skipped_{0};
+  std::atomic<std::uint64_t> clients_dropped_{0};
+  std::atomic<std::uint64_t> bytes_sent_{0};
+};
+
+// Spectator client mode of valentine_tui: connects to `path` and draws the
+// streamed board until Esc or q. Returns the process exit code.
+int RunSpectator(const std::string& path);
+
+}  // namespace vday
@@ -0,0 +1,36 @@
+#include "startup.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace vday {
+
+StartupTrace::StartupTrace() : start_(std::chrono::steady_clock::now()) {}
+
+void StartupTrace::Mark(const std::string& phase) {
+  const auto at = std::chrono::steady_clock::now() - start_;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& existing : phases_) {
+    if (existing.name == phase) {
+      return;
+    }
+  }
+  phases_.push_back(Phase{phase, at});
+}
+
+std::string StartupTrace::Report() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Phase> phases = phases_;
+  std::sort(phases.begin(), phases.end(),
+            [](const Phase& a, const Phase& b) { return a.at < b.at; });
+  std::string out = "startup phases (ms since start)\n";
+  char line[128];
+  for (const auto& phase : phases) {
+    std::snprintf(line, sizeof(line), "  %9.3f  %s\n",
+                  std::chrono::duration<double, std::milli>(phase.at).count(), phase.name.c_str());
+    out += line;
+  }
+  return out;
+}
+
+}  // namespace vday
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vday {
+
+// Timestamps for named startup phases, relative to construction. Safe to mark
+// from any thread; only the first mark of each phase is kept.
+class StartupTrace {
+ public:
+  StartupTrace();
+
+  void Mark(const std::string& phase);
+  std::string Report() const;
+
+ private:
+  struct Phase {
+    std::string name;
+    std::chrono::steady_clock::duration at;
+  };
+
+  std::chrono::steady_clock::time_point start_;
+  mutable std::mutex mutex_;
+  std::vector<Phase> phases_;
+};
+
+}  // namespace vday
@@ -1,49 +1,207 @@
 #pragma once
 
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <deque>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 namespace vday {
 
+// What Push does when a bounded queue is full.
+enum class OverflowPolicy {
+  Block,       // wait for room (or Close)
+  DropOldest,  // evict the front element to make room
+  DropNewest,  // discard the element being pushed
+};
+
+// Mutex-protected FIFO. Unbounded unless constructed with a capacity. After
+// Close(), pushes fail and waiting consumers wake; elements already queued
+// can still be popped.
 template <typename T>
 class ThreadSafeQueue {
  public:
-  void Push(const T& value) {
+  ThreadSafeQueue() = default;
+  explicit ThreadSafeQueue(size_t capacity, OverflowPolicy policy = OverflowPolicy::Block)
+      : capacity_(capacity), policy_(policy) {}
+
+  // Returns false when the element was not queued: the queue is closed, or it
+  // is full under DropNewest.
+  bool Push(const T& value) { return Emplace(value); }
+  bool Push(T&& value) { return Emplace(std::move(value)); }
+
+  template <typename... Args>
+  bool Emplace(Args&&... args) {
     {
-      std::lock_guard<std::mutex> lock(mutex_);
-      queue_.push_back(value);
+      std::unique_lock<std::mutex> lock(mutex_);
+      // A closed queue keeps what it has; nothing is evicted for a push that
+      // cannot happen.
+      if (closed_) {
+        return false;
+      }
+      if (capacity_ > 0 && queue_.size() >= capacity_) {
+        if (policy_ == OverflowPolicy::Block) {
+          not_full_.wait(lock, [&] { return closed_ || queue_.size() < capacity_; });
+        } else if (policy_ == OverflowPolicy::DropOldest) {
+          queue_.pop_front();
+          dropped_++;
+        } else {
+          dropped_++;
+          return false;
+        }
+      }
+      if (closed_) {
+        return false;
+      }
+      queue_.emplace_back(std::forward<Args>(args)...);
     }
-    cv_.notify_one();
+    not_empty_.notify_one();
+    return true;
   }
 
   bool TryPop(T& out) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (queue_.empty()) {
-      return false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (queue_.empty()) {
+        return false;
+      }
+      PopFront(out);
     }
-    out = queue_.front();
-    queue_.pop_front();
+    NotifyNotFull();
     return true;
   }
 
+  // Blocks until an element arrives. Returns false once the queue is closed
+  // and empty.
   bool WaitPop(T& out) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    cv_.wait(lock, [&] { return !queue_.empty(); });
-    out = queue_.front();
-    queue_.pop_front();
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_empty_.wait(lock, [&] { return closed_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return false;
+      }
+      PopFront(out);
+    }
+    NotifyNotFull();
+    return true;
+  }
+
+  // Like WaitPop, but Wake() also ends the wait. Returns false when woken or
+  // closed with nothing queued.
+  bool WaitPopOrWake(T& out) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_empty_.wait(lock, [&] { return closed_ || woken_ || !queue_.empty(); });
+      woken_ = false;
+      if (queue_.empty()) {
+        return false;
+      }
+      PopFront(out);
+    }
+    NotifyNotFull();
+    return true;
+  }
+
+  // Ends the current (or next) WaitPopOrWake without queueing anything. It
+  // never allocates and can't be dropped by the overflow policy.
+  void Wake() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      woken_ = true;
+    }
+    not_empty_.notify_one();
+  }
+
+  // Like WaitPop, but also gives up after `timeout`.
+  template <typename Rep, typename Period>
+  bool WaitPopFor(T& out, std::chrono::duration<Rep, Period> timeout) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_empty_.wait_for(lock, timeout, [&] { return closed_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return false;
+      }
+      PopFront(out);
+    }
+    NotifyNotFull();
     return true;
   }
 
+  // Moves every queued element onto the end of `out` under a single lock and
+  // returns how many were taken.
+  size_t DrainInto(std::vector<T>& out) {
+    size_t count = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      count = queue_.size();
+      for (auto& value : queue_) {
+        out.push_back(std::move(value));
+      }
+      queue_.clear();
+    }
+    if (count > 0) {
+      NotifyNotFull();
+    }
+    return count;
+  }
+
+  void Close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+  // Accepts pushes again after Close(), e.g. when a worker is restarted.
+  void Reopen() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = false;
+  }
+
   void Clear() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.clear();
+    }
+    NotifyNotFull();
+  }
+
+  size_t Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+  }
+
+  // Elements discarded by DropOldest/DropNewest since construction.
+  size_t Dropped() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    queue_.clear();
+    return dropped_;
   }
 
  private:
-  std::mutex mutex_;
-  std::condition_variable cv_;
+  void PopFront(T& out) {
+    out = std::move(queue_.front());
+    queue_.pop_front();
+  }
+
+  void NotifyNotFull() {
+    if (capacity_ > 0 && policy_ == OverflowPolicy::Block) {
+      not_full_.notify_all();
+    }
+  }
+
+  mutable std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
   std::deque<T> queue_;
+  size_t capacity_ = 0;
+  OverflowPolicy policy_ = OverflowPolicy::Block;
+  size_t dropped_ = 0;
+  bool closed_ = false;
+  bool woken_ = false;
 };
 
 }  // namespace vday
@@ -0,0 +1,117 @@
+#include "thread_tuning.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace vday {
+
+std::string ApplyThreadTuning(const char* name, const ThreadTuning& tuning) {
+  std::string summary = name;
+  summary += ":";
+#ifdef __linux__
+  // Names are limited to 15 characters plus the terminator.
+  char short_name[16] = {};
+  std::snprintf(short_name, sizeof(short_name), "vday-%s", name);
+  pthread_setname_np(pthread_self(), short_name);
+
+  if (tuning.cpu >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    bool pinned = false;
+    if (tuning.cpu < CPU_SETSIZE) {
+      CPU_SET(tuning.cpu, &set);
+      pinned = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+    summary += " cpu " + std::to_string(tuning.cpu) + (pinned ? "," : " refused,");
+  }
+
+  bool realtime = false;
+  if (tuning.rt_priority > 0) {
+    sched_param param{};
+    param.sched_priority = std::clamp(tuning.rt_priority, sched_get_priority_min(SCHED_FIFO),
+                                      sched_get_priority_max(SCHED_FIFO));
+    realtime = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+    summary += realtime ? " SCHED_FIFO " + std::to_string(param.sched_priority) + ","
+                        : std::string(" SCHED_FIFO denied,");
+  }
+
+  // On Linux nice is per thread, so this only affects the calling thread.
+  if (!realtime && tuning.nice != 0) {
+    const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    const bool niced = setpriority(PRIO_PROCESS, tid, tuning.nice) == 0;
+    summary += " nice " + std::to_string(tuning.nice) + (niced ? "," : " denied,");
+  }
+#else
+  (void)tuning;
+  summary += " tuning unsupported,";
+#endif
+  if (summary.back() == ',') {
+    summary.pop_back();
+  } else {
+    summary += " default";
+  }
+  return summary;
+}
+
+JitterStats::JitterStats() {
+  values_.reserve(kMaxSamples);
+}
+
+void JitterStats::Add(std::chrono::steady_clock::duration lateness) {
+  const std::int64_t ns = std::max<std::int64_t>(
+      0, std::chrono::duration_cast<std::chrono::nanoseconds>(lateness).count());
+  if (values_.size() < kMaxSamples) {
+    values_.push_back(ns);
+  } else {
+    values_[next_] = ns;
+    next_ = (next_ + 1) % kMaxSamples;
+  }
+  max_ = std::max(max_, ns);
+  count_++;
+}
+
+void JitterStats::Clear() {
+  values_.clear();
+  next_ = 0;
+  count_ = 0;
+  max_ = 0;
+}
+
+size_t JitterStats::Count() const {
+  return count_;
+}
+
+std::string JitterStats::Header() {
+  char line[160];
+  std::snprintf(line, sizeof(line), "lateness (microseconds)\n  %-14s %8s %10s %10s %10s %10s\n",
+                "thread", "count", "p50", "p99", "p999", "max");
+  return line;
+}
+
+std::string JitterStats::Report(const std::string& label) const {
+  std::vector<std::int64_t> sorted = values_;
+  std::sort(sorted.begin(), sorted.end());
+  auto percentile = [&](double p) {
+    if (sorted.empty()) {
+      return 0.0;
+    }
+    const size_t index =
+        std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5));
+    return static_cast<double>(sorted[index]) / 1000.0;
+  };
+  char line[160];
+  std::snprintf(line, sizeof(line), "  %-14s %8zu %10.1f %10.1f %10.1f %10.1f\n", label.c_str(), count_,
+                percentile(0.50), percentile(0.99), percentile(0.999),
+                static_cast<double>(max_) / 1000.0);
+  return line;
+}
+
+}  // namespace vday
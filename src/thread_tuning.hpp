@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vday {
+
+// Scheduling requests for one worker thread. Everything is best effort: a
+// request the process is not allowed to make is skipped and reported.
+struct ThreadTuning {
+  int cpu = -1;          // pin to this CPU; -1 leaves affinity alone
+  int rt_priority = 0;   // SCHED_FIFO priority; 0 keeps the default policy
+  int nice = 0;          // applied when SCHED_FIFO is off or was refused
+};
+
+// Names the calling thread and applies `tuning` to it. Returns a one-line
+// summary of what took effect, e.g. "game: cpu 2, SCHED_FIFO denied, nice -5".
+std::string ApplyThreadTuning(const char* name, const ThreadTuning& tuning);
+
+// How late each periodic deadline was met. Written by the owning thread and
+// read once it has been joined.
+class JitterStats {
+ public:
+  JitterStats();
+
+  void Add(std::chrono::steady_clock::duration lateness);
+  void Clear();
+  size_t Count() const;
+  // Title and column header for a table of Report() rows.
+  static std::string Header();
+  std::string Report(const std::string& label) const;
+
+ private:
+  static constexpr size_t kMaxSamples = 1 << 16;
+
+  std::vector<std::int64_t> values_;
+  size_t next_ = 0;
+  size_t count_ = 0;
+  std::int64_t max_ = 0;
+};
+
+}  // namespace vday
@@ -0,0 +1,213 @@
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace vday {
+
+TimerWheel::TimerWheel(std::uint64_t now) : now_(now) {}
+
+TimerWheel::Id TimerWheel::Schedule(std::uint64_t deadline, Callback callback) {
+  std::uint32_t index;
+  if (!free_.empty()) {
+    index = free_.back();
+    free_.pop_back();
+  } else {
+    index = static_cast<std::uint32_t>(timers_.size());
+    timers_.emplace_back();
+  }
+  Timer& timer = timers_[index];
+  timer.deadline = std::max(deadline, now_);
+  timer.callback = std::move(callback);
+  Place(index);
+  live_++;
+  return (Id{timer.generation} << 32) | index;
+}
+
+bool TimerWheel::Cancel(Id id) {
+  if (Find(id) == nullptr) {
+    return false;
+  }
+  const auto index = static_cast<std::uint32_t>(id);
+  Unlink(index);
+  Release(index);
+  return true;
+}
+
+bool TimerWheel::Pending(Id id) const {
+  return Find(id) != nullptr;
+}
+
+std::optional<std::uint64_t> TimerWheel::Deadline(Id id) const {
+  const Timer* timer = Find(id);
+  if (timer == nullptr) {
+    return std::nullopt;
+  }
+  return timer->deadline;
+}
+
+std::optional<std::uint64_t> TimerWheel::NextDeadline() const {
+  // Every level-0 timer is in now's block of 64, each level-L timer in a later
+  // block than any level below it, and within a level lower slots come first.
+  // Level-0 slots are single units, so their deadline is the slot itself.
+  if (occupied_[0] != 0) {
+    return (now_ & ~std::uint64_t{kSlots - 1}) | static_cast<std::uint64_t>(std::countr_zero(occupied_[0]));
+  }
+  for (int level = 1; level < kLevels; ++level) {
+    if (occupied_[level] != 0) {
+      return EarliestIn(level * kSlots + std::countr_zero(occupied_[level]));
+    }
+  }
+  if (lists_[kOverflowList].head != kNone) {
+    return EarliestIn(kOverflowList);
+  }
+  return std::nullopt;
+}
+
+size_t TimerWheel::Advance(std::uint64_t now) {
+  size_t fired = 0;
+  for (;;) {
+    const auto next = NextDeadline();
+    if (!next || *next > now) {
+      break;
+    }
+    MoveTo(*next);
+    // Everything due at now_ sits in one level-0 slot. It moves to the due
+    // list so callbacks can still cancel timers that have not run yet.
+    const int slot = static_cast<int>(now_ & (kSlots - 1));
+    lists_[kDueList] = std::exchange(lists_[slot], List{});
+    for (std::uint32_t i = lists_[kDueList].head; i != kNone; i = timers_[i].next) {
+      timers_[i].list = kDueList;
+    }
+    occupied_[0] &= ~(std::uint64_t{1} << slot);
+    while (lists_[kDueList].head != kNone) {
+      const std::uint32_t index = lists_[kDueList].head;
+      Unlink(index);
+      Callback callback = std::move(timers_[index].callback);
+      Release(index);
+      callback();
+      fired++;
+    }
+  }
+  MoveTo(std::max(now, now_));
+  return fired;
+}
+
+void TimerWheel::Clear() {
+  for (std::uint32_t index = 0; index < timers_.size(); ++index) {
+    if (timers_[index].list >= 0) {
+      Unlink(index);
+      Release(index);
+    }
+  }
+}
+
+void TimerWheel::Place(std::uint32_t index) {
+  const std::uint64_t deadline = timers_[index].deadline;
+  for (int level = 0; level < kLevels; ++level) {
+    const int shift = (level + 1) * kLevelBits;
+    if ((deadline >> shift) == (now_ >> shift)) {
+      const int slot = static_cast<int>((deadline >> (level * kLevelBits)) & (kSlots - 1));
+      Link(level * kSlots + slot, index);
+      occupied_[level] |= std::uint64_t{1} << slot;
+      return;
+    }
+  }
+  Link(kOverflowList, index);
+}
+
+void TimerWheel::Link(int list, std::uint32_t index) {
+  Timer& timer = timers_[index];
+  List& target = lists_[list];
+  timer.list = list;
+  timer.prev = target.tail;
+  timer.next = kNone;
+  if (target.tail != kNone) {
+    timers_[target.tail].next = index;
+  } else {
+    target.head = index;
+  }
+  target.tail = index;
+}
+
+void TimerWheel::Unlink(std::uint32_t index) {
+  Timer& timer = timers_[index];
+  List& source = lists_[timer.list];
+  if (timer.prev != kNone) {
+    timers_[timer.prev].next = timer.next;
+  } else {
+    source.head = timer.next;
+  }
+  if (timer.next != kNone) {
+    timers_[timer.next].prev = timer.prev;
+  } else {
+    source.tail = timer.prev;
+  }
+  if (source.head == kNone && timer.list < kOverflowList) {
+    occupied_[timer.list / kSlots] &= ~(std::uint64_t{1} << (timer.list % kSlots));
+  }
+  timer.prev = kNone;
+  timer.next = kNone;
+  timer.list = -1;
+}
+
+void TimerWheel::Replace(int list) {
+  std::uint32_t index = std::exchange(lists_[list], List{}).head;
+  if (list < kOverflowList) {
+    occupied_[list / kSlots] &= ~(std::uint64_t{1} << (list % kSlots));
+  }
+  while (index != kNone) {
+    const std::uint32_t next = timers_[index].next;
+    Place(index);
+    index = next;
+  }
+}
+
+void TimerWheel::MoveTo(std::uint64_t now) {
+  const std::uint64_t old = now_;
+  if (now == old) {
+    return;
+  }
+  now_ = now;
+  // Advance never skips a due timer, so the only slots that need moving down
+  // are the ones whose block now contains now_, top level first.
+  if ((now >> (kLevels * kLevelBits)) != (old >> (kLevels * kLevelBits))) {
+    Replace(kOverflowList);
+  }
+  for (int level = kLevels - 1; level >= 1; --level) {
+    const int shift = level * kLevelBits;
+    if ((now >> shift) != (old >> shift)) {
+      Replace(level * kSlots + static_cast<int>((now >> shift) & (kSlots - 1)));
+    }
+  }
+}
+
+void TimerWheel::Release(std::uint32_t index) {
+  Timer& timer = timers_[index];
+  timer.callback = nullptr;
+  // Skips 0 on wrap-around so no id is ever 0.
+  timer.generation = timer.generation == 0xFFFFFFFFu ? 1 : timer.generation + 1;
+  free_.push_back(index);
+  live_--;
+}
+
+std::uint64_t TimerWheel::EarliestIn(int list) const {
+  std::uint64_t earliest = ~std::uint64_t{0};
+  for (std::uint32_t i = lists_[list].head; i != kNone; i = timers_[i].next) {
+    earliest = std::min(earliest, timers_[i].deadline);
+  }
+  return earliest;
+}
+
+const TimerWheel::Timer* TimerWheel::Find(Id id) const {
+  const auto index = static_cast<std::uint32_t>(id);
+  const auto generation = static_cast<std::uint32_t>(id >> 32);
+  if (index >= timers_.size()) {
+    return nullptr;
+  }
+  const Timer& timer = timers_[index];
+  return timer.generation == generation && timer.list >= 0 ? &timer : nullptr;
+}
+
+}  // namespace vday
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace vday {
+
+// Hierarchical timing wheel over an integer clock: microseconds for the app,
+// simulation ticks for the engine. Four levels of 64 slots cover 2^24 units
+// ahead of now(); later deadlines wait in an overflow list. Schedule and
+// Cancel are O(1), and a timer moves down at most once per level before it
+// fires. Advance jumps straight to the next occupied slot, so an idle wheel
+// costs nothing however far the clock moves.
+//
+// Not thread-safe. Callbacks run inside Advance and may schedule or cancel
+// timers, including ones due in the same Advance.
+class TimerWheel {
+ public:
+  // 0 is never a valid id, so it can mean "not armed".
+  using Id = std::uint64_t;
+  using Callback = std::function<void()>;
+
+  explicit TimerWheel(std::uint64_t now = 0);
+
+  std::uint64_t now() const { return now_; }
+  size_t size() const { return live_; }
+
+  // Fires on the first Advance to `deadline` or later. A deadline already
+  // passed fires on the next Advance.
+  Id Schedule(std::uint64_t deadline, Callback callback);
+  // False if the timer already fired or was cancelled.
+  bool Cancel(Id id);
+  bool Pending(Id id) const;
+  std::optional<std::uint64_t> Deadline(Id id) const;
+
+  // The earliest pending deadline, exact at every level.
+  std::optional<std::uint64_t> NextDeadline() const;
+
+  // Moves the clock to `now` (never backwards) and fires every timer due by
+  // then, in deadline order. Returns how many fired.
+  size_t Advance(std::uint64_t now);
+
+  // Drops every timer without firing it.
+  void Clear();
+
+ private:
+  static constexpr int kLevelBits = 6;
+  static constexpr int kSlots = 1 << kLevelBits;
+  static constexpr int kLevels = 4;
+  static constexpr int kOverflowList = kLevels * kSlots;
+  static constexpr int kDueList = kOverflowList + 1;
+  static constexpr int kListCount = kDueList + 1;
+  static constexpr std::uint32_t kNone = 0xFFFFFFFFu;
+
+  struct Timer {
+    std::uint64_t deadline = 0;
+    Callback callback;
+    std::uint32_t generation = 1;
+    std::uint32_t prev = kNone;
+    std::uint32_t next = kNone;
+    int list = -1;  // -1 while free
+  };
+
+  struct List {
+    std::uint32_t head = kNone;
+    std::uint32_t tail = kNone;
+  };
+
+  void Place(std::uint32_t index);
+  void Link(int list, std::uint32_t index);
+  void Unlink(std::uint32_t index);
+  // Detaches a whole list and places its timers again against now_.
+  void Replace(int list);
+  // Moves now_ forward, cascading the slots that now cover it.
+  void MoveTo(std::uint64_t now);
+  void Release(std::uint32_t index);
+  std::uint64_t EarliestIn(int list) const;
+  const Timer* Find(Id id) const;
+
+  std::uint64_t now_;
+  std::vector<Timer> timers_;
+  std::vector<std::uint32_t> free_;
+  std::array<List, kListCount> lists_{};
+  // One bit per non-empty slot of each level.
+  std::array<std::uint64_t, kLevels> occupied_{};
+  size_t live_ = 0;
+};
+
+}  // namespace vday